@@ -21,7 +21,7 @@
 #define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 130 )
 #define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 128 * 1024 ) )
 #define configMAX_TASK_NAME_LEN                 ( 12 )
-#define configUSE_TRACE_FACILITY                0
+#define configUSE_TRACE_FACILITY                1 /* vTaskGetInfo() for per-task CPU time */
 #define configUSE_16_BIT_TICKS                  0
 #define configIDLE_SHOULD_YIELD                 1
 #define configUSE_MUTEXES                       1
@@ -52,7 +52,8 @@
 /* Run time stats gathering configuration options. */
 unsigned long ulGetRunTimeCounterValue(void);
 void vConfigureTimerForRunTimeStats(void);
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_HZ               ( 1000000UL ) /* Microseconds, see Run-time-stats-utils.c */
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vConfigureTimerForRunTimeStats()
 #define portGET_RUN_TIME_COUNTER_VALUE() ulGetRunTimeCounterValue()
 
@@ -93,6 +94,31 @@ extern void vGenerateCoreBInterrupt(void* xUpdatedMessageBuffer);
 /* Include FreeRTOS+Trace macro definitions. */
 #include "trcRecorder.h"
 
+/* Exact context-switch accounting for the EDF demo (edf_demo.c). These expand
+inside tasks.c, where pxCurrentTCB and pxReadyTasksLists are visible; a task
+switched out while still in its ready list was preempted. The recorder's own
+snapshot-mode switch-in hook is chained so FreeRTOS+Trace keeps recording task
+switches; that recorder does not hook the switch out. */
+#if defined( TRC_USE_TRACEALYZER_RECORDER ) && ( TRC_USE_TRACEALYZER_RECORDER == 1 )
+    #if ( TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_SNAPSHOT )
+        #define edfTRC_TASK_SWITCHED_IN() trcKERNEL_HOOKS_TASK_SWITCH( TRACE_GET_CURRENT_TASK() )
+    #else
+        #error "Chain the streaming recorder's traceTASK_SWITCHED_IN/OUT into the EDF hooks below"
+    #endif
+#else
+    #define edfTRC_TASK_SWITCHED_IN()
+#endif
+void vEdfTraceSwitchedOut(void* pvTask, void* pvTaskTag, long lStillReady);
+void vEdfTraceSwitchedIn(void* pvTask, void* pvTaskTag, unsigned long ulPriority);
+#undef traceTASK_SWITCHED_OUT
+#define traceTASK_SWITCHED_OUT() vEdfTraceSwitchedOut( ( void * ) pxCurrentTCB, ( void * ) pxCurrentTCB->pxTaskTag, \
+    ( long ) listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) )
+#undef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN() do { \
+        vEdfTraceSwitchedIn( ( void * ) pxCurrentTCB, ( void * ) pxCurrentTCB->pxTaskTag, ( unsigned long ) pxCurrentTCB->uxPriority ); \
+        edfTRC_TASK_SWITCHED_IN(); \
+    } while( 0 )
+
 // *** CHANGE: Disable time slicing for RM-RCS to ensure boosted tasks run to completion ***
 #define configUSE_TIME_SLICING                  0
 
@@ -0,0 +1,52 @@
+// High-resolution time base for the FreeRTOS run-time statistics. The kernel
+// calls vConfigureTimerForRunTimeStats() from vTaskStartScheduler() and reads
+// ulGetRunTimeCounterValue() at every context switch; the EDF demo uses the
+// same counter for response times and scheduler cost.
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+static LARGE_INTEGER s_llStart;
+static LONGLONG s_llCountsPerTick = 1; // Performance-counter counts per run-time counter tick
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    LARGE_INTEGER llFrequency;
+
+    QueryPerformanceFrequency(&llFrequency);
+    s_llCountsPerTick = llFrequency.QuadPart / configRUN_TIME_COUNTER_HZ;
+    if (s_llCountsPerTick == 0)
+        s_llCountsPerTick = 1;
+    QueryPerformanceCounter(&s_llStart);
+}
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    LARGE_INTEGER llNow;
+
+    QueryPerformanceCounter(&llNow);
+    return (unsigned long)((llNow.QuadPart - s_llStart.QuadPart) / s_llCountsPerTick);
+}
+#else
+#include <time.h>
+
+static struct timespec s_xStart;
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &s_xStart);
+}
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    struct timespec xNow;
+    long long llNs;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    llNs = (long long)(xNow.tv_sec - s_xStart.tv_sec) * 1000000000LL + (xNow.tv_nsec - s_xStart.tv_nsec);
+    return (unsigned long)(llNs / (1000000000LL / configRUN_TIME_COUNTER_HZ));
+}
+#endif
@@ -1,17 +1,33 @@
-#include "edf_demo.h" 
+#include "edf_demo.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include "FreeRTOS.h"
 #include "task.h"
-#include "semphr.h"
+#include "timers.h"
 #include "sensors.h"
 #include "edf_demo_config.h"
 #include "stdbool.h"
 
 // --- Module-static variables ---
-static TaskHandle_t s_highestPrioTaskHandle = NULL;
+static int s_highestPrioTaskIndex = -1;
 static TickType_t s_hyperperiod = 0;
 static bool s_simulationComplete = false;
+// Run options, set before a demo starts
+static uint32_t s_runHyperperiods = 1;
+static TickType_t s_simulationEnd = 0; // Last tick of the run
+static bool s_printEvents = true;
+static void (*s_pxEndCallback)(void) = NULL;
+
+// Distribution of times in run-time counter units
+typedef struct {
+    uint32_t ulCount;
+    uint32_t ulMin;
+    uint32_t ulMax;
+    uint64_t ullTotal;
+    uint32_t ulBins[EDF_HISTOGRAM_BINS];
+} EdfHistogram_t;
 
 // Structure to hold EDF task info
 typedef struct {
@@ -20,12 +36,221 @@ typedef struct {
     TickType_t xNextDeadline;
     const char* pcTaskName;
     int taskIndex;
-    UBaseType_t currentPriority;
+    UBaseType_t currentPriority; // Band assigned by EDF
     int jobCount;  // Track job number for better logging
+    TickType_t xRelativeDeadlineTicks;
+    EdfJobFunction_t pxJob;
+    UBaseType_t appliedPriority; // Priority the kernel currently has
+    bool updateQueued;           // In s_priorityUpdates, waiting to be applied
+    TickType_t xNextRelease;     // Used by EDF_MODE_TICK_HOOK
+    uint8_t ucOverrunPolicy;     // EDF_OVERRUN_*
+    bool jobMissed;              // Current job is past its deadline and has been counted
+    bool abortJob;               // A late job is not started (EDF_OVERRUN_ABORT)
+    bool skipNext;               // Next release is dropped (EDF_OVERRUN_SKIP_NEXT)
+    uint32_t ulMisses;
+    uint32_t ulAborted;
+    uint32_t ulSkipped;
+    uint32_t ulReleaseTime;      // Run-time counter at the current job's release
+    EdfHistogram_t xResponse;    // Release to completion, per job
+    uint32_t ulCpuTime;          // Kernel run-time counter, captured before the task is deleted
+    uint16_t usStackDepth;       // Words carved from s_stackPool
+    UBaseType_t uxStackFree;     // Stack high-water mark (words never used), captured with ulCpuTime
 } EdfTaskInfo_t;
 
-static EdfTaskInfo_t s_xEdfTasks[NUM_EDF_TASKS];
-static SemaphoreHandle_t s_xEdfMutex = NULL;
+// Every EDF object is statically allocated, so startup never touches the heap
+// and a table that does not fit is rejected before any task exists
+static StaticTask_t s_xTaskBuffers[EDF_MAX_TASKS];
+static StackType_t s_stackPool[EDF_STACK_POOL_WORDS];
+static StaticTask_t s_xLoggerBuffer;
+static StackType_t s_loggerStack[EDF_LOGGER_STACK_SIZE];
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+static StaticTask_t s_xSchedulerBuffer;
+static StackType_t s_schedulerStack[EDF_SCHEDULER_STACK_SIZE];
+static UBaseType_t s_schedulerStackFree = 0;
+#endif
+
+static EdfTaskInfo_t s_xEdfTasks[EDF_MAX_TASKS];
+static int s_numEdfTasks = 0;
+
+// Binary min-heap of task indices, updated under a critical section
+typedef struct {
+    int items[EDF_MAX_TASKS];
+    int pos[EDF_MAX_TASKS]; // Position of each task in items, -1 if absent
+    int size;
+    bool (*before)(int a, int b);
+} TaskHeap_t;
+
+// Released, unfinished jobs by absolute deadline
+static TaskHeap_t s_jobHeap;
+// Tasks waiting for their next release by release time (EDF_MODE_TICK_HOOK)
+static TaskHeap_t s_releaseHeap;
+
+// Tasks holding a distinct EDF priority after the last ranking
+static int s_ranked[EDF_PRIORITY_LEVELS];
+static int s_rankedCount = 0;
+
+// Tasks whose band changed but whose kernel priority has not been set yet.
+// Each task is queued at most once, so the ring never overflows.
+static int s_priorityUpdates[EDF_MAX_TASKS];
+static int s_updateHead = 0;
+static int s_updateCount = 0;
+
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+// Cost of the tick hook, in run-time counter units
+static unsigned long s_hookTicks = 0;
+static unsigned long s_hookReleases = 0;
+static uint64_t s_hookTotal = 0;
+static uint32_t s_hookMax = 0;
+static bool s_applyPending = false; // Priority updates handed to the timer daemon
+#else
+static TaskHandle_t s_xEdfSchedulerHandle = NULL;
+static unsigned long s_schedulerWakeups = 0;
+#endif
+// Time spent ranking and applying priorities, per scheduler invocation (the
+// scheduler task, or the timer daemon in EDF_MODE_TICK_HOOK)
+static EdfHistogram_t s_schedulerCost;
+static uint32_t s_schedulerCpuTime = 0;
+
+// Binary event records written by the tasks and formatted by the logger task,
+// so console I/O never runs inside a job or the scheduler
+typedef enum {
+    EDF_LOG_JOB_START, // ulJob, xDeadline
+    EDF_LOG_JOB_END,   // ulJob, lValue = job result
+    EDF_LOG_PRIORITY,  // lValue = new priority, sExtra = old priority, xDeadline
+    EDF_LOG_ORDER,     // lValue = priority, sExtra = rank, ulJob = ranked count, xDeadline = jobs in the bottom band
+    EDF_LOG_PREEMPT,   // usTask preempts task sExtra
+    EDF_LOG_MISS,      // ulJob finished after xDeadline, sExtra = overrun policy
+    EDF_LOG_ABORT,     // ulJob was not run
+    EDF_LOG_SKIP,      // Release of ulJob was dropped
+    EDF_LOG_WINDOW,    // Aggregator fused window ulJob, kept in s_sensorWindows
+    EDF_LOG_END        // End of the simulation
+} EdfLogEvent_t;
+
+typedef struct {
+    TickType_t xTick;
+    uint32_t ulTime;     // Run-time counter, for the exported trace
+    TickType_t xDeadline;
+    uint32_t ulJob;
+    int32_t lValue;
+    int16_t sExtra;
+    uint16_t usTask;
+    uint8_t ucEvent;
+} EdfLogRecord_t;
+
+// Many writers serialised by a few-instruction critical section, one reader
+// (the logger task) that never blocks them. Full means the record is dropped.
+static EdfLogRecord_t s_logRing[EDF_LOG_RING_SIZE];
+static volatile uint32_t s_logHead = 0; // Next slot to write
+static volatile uint32_t s_logTail = 0; // Next slot to read
+static uint32_t s_logWritten = 0;
+static uint32_t s_logDropped = 0;
+static uint32_t s_logHighWater = 0;
+
+// Context switches recorded by the kernel trace hooks. Tasks are told apart
+// by their application tag: EDF task i has tag i + 1, the scheduler and the
+// logger have their own, and anything else (idle, timer daemon) has none.
+#define EDF_TRACE_OTHER      0
+#define EDF_TRACE_SCHEDULER  (EDF_MAX_TASKS + 1)
+#define EDF_TRACE_LOGGER     (EDF_MAX_TASKS + 2)
+#define EDF_TRACE_IDS        (EDF_MAX_TASKS + 3)
+
+typedef struct {
+    uint32_t ulTime;     // Run-time counter at the switch
+    uint8_t ucFrom;
+    uint8_t ucTo;
+    uint8_t ucPreempted; // ucFrom was still ready to run
+} EdfSwitchRecord_t;
+
+typedef struct {
+    uint32_t ulPreempted;
+    uint32_t ulYielded;  // Blocked, suspended or deleted itself
+} EdfSwitchCount_t;
+
+// Written only inside the kernel's context switch, read by the logger task
+static EdfSwitchRecord_t s_switchRing[EDF_TRACE_RING_SIZE];
+static volatile uint32_t s_switchHead = 0;
+static volatile uint32_t s_switchTail = 0;
+static uint32_t s_switchDropped = 0;
+static EdfSwitchCount_t s_switchPairs[EDF_TRACE_IDS][EDF_TRACE_IDS];
+static bool s_traceEnabled = false;
+
+// Chrome Trace Event (Perfetto) JSON written by the logger task as it drains
+// both rings, so the file grows with the run but memory does not. Each task
+// is a track, using its trace tag as the thread id.
+static FILE* s_traceFile = NULL;
+static uint32_t s_traceStart = 0;   // Run-time counter at time 0 of the trace
+static uint32_t s_traceEvents = 0;
+static void* s_switchedOutTask = NULL;
+static uint8_t s_switchedOutId = EDF_TRACE_OTHER;
+static bool s_switchedOutPreempted = false;
+// Switches from one EDF task running a job to another, ignoring whatever ran
+// in between (release bookkeeping included)
+static int s_lastEdfId = EDF_TRACE_OTHER;
+static bool s_lastEdfPreempted = false;
+static uint32_t s_edfSwitches = 0;
+static uint32_t s_edfPreemptions = 0;
+
+// Sensor pipeline: each sensor task is the only producer of its ring and the
+// aggregator the only consumer, so head and tail need no lock. Samples are
+// generated straight into their slot and fused where they lie.
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define edf_compiler_barrier() _ReadWriteBarrier()
+#else
+#define edf_compiler_barrier() __asm__ __volatile__("" ::: "memory")
+#endif
+
+typedef struct {
+    int values[EDF_SENSOR_RING_SIZE];
+    TickType_t xTicks[EDF_SENSOR_RING_SIZE];
+    uint32_t ulTimes[EDF_SENSOR_RING_SIZE]; // Run-time counter when sampled
+    volatile uint32_t head; // Written by the sensor task only
+    volatile uint32_t tail; // Written by the aggregator only
+    uint32_t ulPublished;
+    uint32_t ulDropped;     // Ring full; the aggregator is too far behind
+} EdfSensorRing_t;
+
+// One stream's share of a window
+typedef struct {
+    uint32_t ulCount;
+    int lMin;
+    int lMax;
+    int64_t llSum;
+    float fRate; // Units per demo second since the previous window's last sample
+} EdfStreamStats_t;
+
+typedef struct {
+    uint32_t ulWindow;
+    EdfStreamStats_t xStreams[SENSOR_COUNT];
+    uint32_t ulOldestAge; // Run-time counts from the oldest sample to the fused result
+    uint32_t ulNewestAge;
+} EdfSensorWindow_t;
+
+static EdfSensorRing_t s_sensorRings[SENSOR_COUNT];
+// Written by the aggregator, formatted by the logger from an EDF_LOG_WINDOW record
+static EdfSensorWindow_t s_sensorWindows[EDF_SENSOR_WINDOW_SLOTS];
+static uint32_t s_sensorWindowCount = 0;
+static int s_aggregatorTask = -1;
+// Last sample fused per stream, for the rate of change across windows
+static int s_lastValue[SENSOR_COUNT];
+static TickType_t s_lastTick[SENSOR_COUNT];
+static bool s_haveLast[SENSOR_COUNT];
+// Whole-run totals
+static EdfStreamStats_t s_streamTotals[SENSOR_COUNT];
+static EdfHistogram_t s_dataAge;
+
+static int publish_temperature(void);
+static int publish_pressure(void);
+static int publish_height(void);
+static int aggregate_sensors(void);
+
+// The three sensor tasks of the original demo, plus the aggregator fusing their readings
+static const EdfTaskDesc_t s_xSensorTasks[] = {
+    { "TempTask",     TEMP_TASK_PERIOD_MS,       0, publish_temperature, 0, EDF_OVERRUN_CONTINUE },
+    { "PressureTask", PRESSURE_TASK_PERIOD_MS,   0, publish_pressure,    0, EDF_OVERRUN_CONTINUE },
+    { "HeightTask",   HEIGHT_TASK_PERIOD_MS,     0, publish_height,      0, EDF_OVERRUN_CONTINUE },
+    { "Aggregator",   AGGREGATOR_TASK_PERIOD_MS, 0, aggregate_sensors,   0, EDF_OVERRUN_CONTINUE },
+};
 
 // Calculate LCM for hyperperiod
 static TickType_t gcd(TickType_t a, TickType_t b) {
@@ -37,449 +262,1488 @@ static TickType_t gcd(TickType_t a, TickType_t b) {
     return a;
 }
 
-static TickType_t lcm(TickType_t a, TickType_t b) {
-    return (a / gcd(a, b)) * b;
-}
-
 static TickType_t calculate_hyperperiod() {
     TickType_t result = s_xEdfTasks[0].xPeriodTicks;
-    for (int i = 1; i < NUM_EDF_TASKS; i++) {
-        result = lcm(result, s_xEdfTasks[i].xPeriodTicks);
+    for (int i = 1; i < s_numEdfTasks; i++) {
+        TickType_t step = s_xEdfTasks[i].xPeriodTicks / gcd(result, s_xEdfTasks[i].xPeriodTicks);
+        // Large unrelated periods overflow the tick counter; run as long as possible
+        if (result > (portMAX_DELAY / 2) / step) {
+            printf("WARNING: hyperperiod too long, simulation capped at %lu ticks\n",
+                (unsigned long)(portMAX_DELAY / 2));
+            return portMAX_DELAY / 2;
+        }
+        result *= step;
     }
     return result;
 }
 
-// --- Task Functions (EDF Specific Names) ---
-static void vTemperatureTask_EDF(void* pvParameters) {
-    TickType_t xLastWakeTime;
-    const TickType_t xFrequency = pdMS_TO_TICKS(TEMP_TASK_PERIOD_MS);
-    int tempValue;
-    int taskIndex = (int)pvParameters;
+static const char* overrun_policy_name(uint8_t ucPolicy) {
+    switch (ucPolicy) {
+    case EDF_OVERRUN_SKIP_NEXT: return "skip next";
+    case EDF_OVERRUN_ABORT: return "abort";
+    case EDF_OVERRUN_DEMOTE: return "demote";
+    default: return "continue";
+    }
+}
 
-    xLastWakeTime = xTaskGetTickCount();
+static void histogram_add(EdfHistogram_t* histogram, uint32_t ulValue) {
+    int bin = 0;
+    while (bin < EDF_HISTOGRAM_BINS - 1 && (ulValue >> bin) != 0)
+        bin++;
+
+    if (histogram->ulCount == 0 || ulValue < histogram->ulMin)
+        histogram->ulMin = ulValue;
+    if (ulValue > histogram->ulMax)
+        histogram->ulMax = ulValue;
+    histogram->ulCount++;
+    histogram->ullTotal += ulValue;
+    histogram->ulBins[bin]++;
+}
 
-    // Initialize job count
-    s_xEdfTasks[taskIndex].jobCount = 1;
+// Non-empty bins on one line, labelled by their upper bound
+static void print_histogram(const EdfHistogram_t* histogram) {
+    printf("     ");
+    for (int i = 0; i < EDF_HISTOGRAM_BINS; i++) {
+        if (histogram->ulBins[i] == 0)
+            continue;
+        if (i == EDF_HISTOGRAM_BINS - 1)
+            printf(" >=%lu:%lu", 1ul << (i - 1), (unsigned long)histogram->ulBins[i]);
+        else
+            printf(" <%lu:%lu", 1ul << i, (unsigned long)histogram->ulBins[i]);
+    }
+    printf("\n");
+}
+
+// Run-time counter value at a past tick; the tick interrupt and the counter
+// are not in phase, so this is good to within one tick
+static uint32_t counter_at_tick(TickType_t xTick, TickType_t xNow) {
+    return (uint32_t)portGET_RUN_TIME_COUNTER_VALUE() -
+        (uint32_t)(xNow - xTick) * (configRUN_TIME_COUNTER_HZ / configTICK_RATE_HZ);
+}
+
+// Remember a task's CPU time and stack high-water mark before its handle goes
+// away. Call inside a critical section, so the handle cannot be deleted meanwhile.
+static void capture_task_stats(EdfTaskInfo_t* task) {
+    if (task->xHandle != NULL) {
+        TaskStatus_t xStatus;
+        vTaskGetInfo(task->xHandle, &xStatus, pdFALSE, eInvalid);
+        task->ulCpuTime = xStatus.ulRunTimeCounter;
+        task->uxStackFree = uxTaskGetStackHighWaterMark(task->xHandle);
+    }
+}
+
+static const char* trace_name(int id) {
+    if (id == EDF_TRACE_SCHEDULER)
+        return "EDFSched";
+    if (id == EDF_TRACE_LOGGER)
+        return "EDFLog";
+    if (id >= 1 && id <= s_numEdfTasks)
+        return s_xEdfTasks[id - 1].pcTaskName;
+    return "(other)";
+}
+
+// Earlier deadline first; ties go to the lower task index
+static bool deadline_before(int a, int b) {
+    if (s_xEdfTasks[a].xNextDeadline != s_xEdfTasks[b].xNextDeadline)
+        return s_xEdfTasks[a].xNextDeadline < s_xEdfTasks[b].xNextDeadline;
+    return a < b;
+}
+
+static bool release_before(int a, int b) {
+    if (s_xEdfTasks[a].xNextRelease != s_xEdfTasks[b].xNextRelease)
+        return s_xEdfTasks[a].xNextRelease < s_xEdfTasks[b].xNextRelease;
+    return a < b;
+}
+
+static void heap_init(TaskHeap_t* heap, bool (*before)(int a, int b)) {
+    heap->size = 0;
+    heap->before = before;
+    for (int i = 0; i < EDF_MAX_TASKS; i++) {
+        heap->pos[i] = -1;
+    }
+}
+
+static void heap_swap(TaskHeap_t* heap, int i, int j) {
+    int temp = heap->items[i];
+    heap->items[i] = heap->items[j];
+    heap->items[j] = temp;
+    heap->pos[heap->items[i]] = i;
+    heap->pos[heap->items[j]] = j;
+}
 
+static void heap_sift_up(TaskHeap_t* heap, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!heap->before(heap->items[pos], heap->items[parent]))
+            break;
+        heap_swap(heap, pos, parent);
+        pos = parent;
+    }
+}
+
+static void heap_sift_down(TaskHeap_t* heap, int pos) {
     for (;;) {
-        // Check if simulation is complete
-        if (s_simulationComplete) {
-            vTaskDelete(NULL);
-            return;
-        }
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < heap->size && heap->before(heap->items[left], heap->items[smallest]))
+            smallest = left;
+        if (right < heap->size && heap->before(heap->items[right], heap->items[smallest]))
+            smallest = right;
+        if (smallest == pos)
+            break;
+        heap_swap(heap, pos, smallest);
+        pos = smallest;
+    }
+}
 
-        // Update deadline for next period
-        TickType_t xDeadlineForNextPeriod = xLastWakeTime + xFrequency;
+static void heap_insert(TaskHeap_t* heap, int taskIndex) {
+    int pos = heap->size++;
+    heap->items[pos] = taskIndex;
+    heap->pos[taskIndex] = pos;
+    heap_sift_up(heap, pos);
+}
 
-        if (xSemaphoreTake(s_xEdfMutex, portMAX_DELAY) == pdTRUE) {
-            s_xEdfTasks[taskIndex].xNextDeadline = xDeadlineForNextPeriod;
-            xSemaphoreGive(s_xEdfMutex);
+static void heap_remove(TaskHeap_t* heap, int taskIndex) {
+    int pos = heap->pos[taskIndex];
+    heap->pos[taskIndex] = -1;
+    if (pos != --heap->size) {
+        int moved = heap->items[heap->size];
+        heap->items[pos] = moved;
+        heap->pos[moved] = pos;
+        heap_sift_up(heap, pos);
+        heap_sift_down(heap, heap->pos[moved]);
+    }
+}
+
+// Copy the k earliest entries in order without disturbing the heap. Only
+// children of entries already taken can be next, so this costs O(k^2)
+// however many tasks there are.
+static int heap_earliest(const TaskHeap_t* heap, int* out, int k) {
+    int frontier[EDF_PRIORITY_LEVELS + 1]; // Heap positions
+    int frontierSize = 0;
+    int count = 0;
+
+    if (heap->size > 0)
+        frontier[frontierSize++] = 0;
+
+    while (count < k && frontierSize > 0) {
+        int best = 0;
+        for (int i = 1; i < frontierSize; i++) {
+            if (heap->before(heap->items[frontier[i]], heap->items[frontier[best]]))
+                best = i;
         }
+        int pos = frontier[best];
+        frontier[best] = frontier[--frontierSize];
+        out[count++] = heap->items[pos];
+
+        if (2 * pos + 1 < heap->size)
+            frontier[frontierSize++] = 2 * pos + 1;
+        if (2 * pos + 2 < heap->size)
+            frontier[frontierSize++] = 2 * pos + 2;
+    }
+    return count;
+}
+
+// Task context only; the tick hook does not log
+static void log_event(EdfLogEvent_t event, int taskIndex, uint32_t ulJob, TickType_t xDeadline,
+    int32_t lValue, int32_t lExtra) {
+    EdfLogRecord_t record = {
+        xTaskGetTickCount(), (uint32_t)portGET_RUN_TIME_COUNTER_VALUE(), xDeadline, ulJob, lValue,
+        (int16_t)lExtra, (uint16_t)taskIndex, (uint8_t)event
+    };
+
+    taskENTER_CRITICAL();
+    uint32_t used = s_logHead - s_logTail;
+    if (used == EDF_LOG_RING_SIZE) {
+        s_logDropped++;
+    }
+    else {
+        s_logRing[s_logHead % EDF_LOG_RING_SIZE] = record;
+        s_logHead++;
+        s_logWritten++;
+        if (used + 1 > s_logHighWater)
+            s_logHighWater = used + 1;
+    }
+    taskEXIT_CRITICAL();
+}
 
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+static void print_summary(void);
 
-        // --- Job Execution START ---
-        TickType_t currentTick = xTaskGetTickCount();
+static const char* const s_sensorNames[SENSOR_COUNT] = { "Temp", "Pressure", "Height" };
 
-        // Check if we've reached the hyperperiod
-        if (currentTick > s_hyperperiod) {
-            s_simulationComplete = true;
+static void print_window(const EdfLogRecord_t* record) {
+    const EdfSensorWindow_t* window = &s_sensorWindows[record->ulJob % EDF_SENSOR_WINDOW_SLOTS];
+    const double counterPerMs = configRUN_TIME_COUNTER_HZ / 1e3;
+
+    // The aggregator has lapped the logger; the slot holds a later window
+    if (window->ulWindow != record->ulJob)
+        return;
+    printf("[%-12s] Tick=%-5lu WINDOW %lu (data age %.1f..%.1f ms)\n",
+        s_xEdfTasks[record->usTask].pcTaskName, (unsigned long)record->xTick, (unsigned long)record->ulJob,
+        window->ulNewestAge / counterPerMs, window->ulOldestAge / counterPerMs);
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+        const EdfStreamStats_t* stream = &window->xStreams[i];
+        if (stream->ulCount == 0) {
+            printf("  - %-8s: no samples\n", s_sensorNames[i]);
             continue;
         }
+        printf("  - %-8s: %lu samples, mean %.1f min %d max %d, rate %+.1f/s\n",
+            s_sensorNames[i], (unsigned long)stream->ulCount, (double)stream->llSum / stream->ulCount,
+            stream->lMin, stream->lMax, stream->fRate);
+    }
+}
 
-        UBaseType_t currentPriority = uxTaskPriorityGet(NULL);
+// Turn one record back into the text the demo has always printed
+static void format_record(const EdfLogRecord_t* record, const EdfLogRecord_t* previous) {
+    const char* name = s_xEdfTasks[record->usTask].pcTaskName;
+
+    switch (record->ucEvent) {
+    case EDF_LOG_JOB_START:
+        printf("[%-12s] Tick=%-5lu START Job %lu (Deadline:%lu)\n",
+            name, (unsigned long)record->xTick, (unsigned long)record->ulJob,
+            (unsigned long)record->xDeadline);
+        break;
+    case EDF_LOG_JOB_END:
+        printf("[%-12s] Tick=%-5lu END Job %lu (Value:%ld)\n",
+            name, (unsigned long)record->xTick, (unsigned long)record->ulJob, (long)record->lValue);
+        break;
+    case EDF_LOG_PRIORITY:
+        if (previous->ucEvent != EDF_LOG_PRIORITY || previous->xTick != record->xTick) {
+            printf("[Scheduler] Tick=%-5lu Priority Updates:\n", (unsigned long)record->xTick);
+        }
+        printf("  - %-12s: %ld -> %ld (Deadline: %lu)\n",
+            name, (long)record->sExtra, (long)record->lValue, (unsigned long)record->xDeadline);
+        break;
+    case EDF_LOG_ORDER:
+        if (record->sExtra == 0)
+            printf("  New Priority Order: ");
+        printf("%s(%ld)%s", name, (long)record->lValue,
+            ((uint32_t)record->sExtra < record->ulJob - 1) ? " > " : "");
+        if ((uint32_t)record->sExtra == record->ulJob - 1) {
+            if (record->xDeadline > 0)
+                printf(" (+%lu more at %lu)", (unsigned long)record->xDeadline, (unsigned long)EDF_BASE_PRIORITY);
+            printf("\n");
+        }
+        break;
+    case EDF_LOG_PREEMPT:
+        printf("  Context Switch: %s preempts %s (earlier deadline)\n\n",
+            name, s_xEdfTasks[record->sExtra].pcTaskName);
+        break;
+    case EDF_LOG_MISS:
+        printf("[%-12s] Tick=%-5lu MISSED Job %lu (Deadline:%lu, late by %lu, %s)\n",
+            name, (unsigned long)record->xTick, (unsigned long)record->ulJob,
+            (unsigned long)record->xDeadline, (unsigned long)(record->xTick - record->xDeadline),
+            overrun_policy_name((uint8_t)record->sExtra));
+        break;
+    case EDF_LOG_ABORT:
+        printf("[%-12s] Tick=%-5lu ABORT Job %lu\n",
+            name, (unsigned long)record->xTick, (unsigned long)record->ulJob);
+        break;
+    case EDF_LOG_SKIP:
+        printf("[%-12s] Tick=%-5lu SKIP Job %lu (overrun catch-up)\n",
+            name, (unsigned long)record->xTick, (unsigned long)record->ulJob);
+        break;
+    case EDF_LOG_WINDOW:
+        print_window(record);
+        break;
+    default:
+        break;
+    }
+}
 
-        printf("[%-12s] Tick=%-5lu START Job %d (Deadline:%lu)\n",
-            s_xEdfTasks[taskIndex].pcTaskName,
-            (unsigned long)currentTick,
-            s_xEdfTasks[taskIndex].jobCount,
-            (unsigned long)xDeadlineForNextPeriod);
-        fflush(stdout);
+static double trace_us(uint32_t ulTime) {
+    return (uint32_t)(ulTime - s_traceStart) / (configRUN_TIME_COUNTER_HZ / 1e6);
+}
 
-        // --- Perform Task Work ---
-        tempValue = getTemperature();
+// Writes s as a JSON string; task names from --table may hold any character
+static void trace_string(const char* s) {
+    fputc('"', s_traceFile);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', s_traceFile);
+        if ((unsigned char)*s >= 0x20)
+            fputc(*s, s_traceFile);
+    }
+    fputc('"', s_traceFile);
+}
 
-        // --- Job Execution END ---
-        printf("[%-12s] Tick=%-5lu END Job %d (Value:%d)\n",
-            s_xEdfTasks[taskIndex].pcTaskName,
-            (unsigned long)xTaskGetTickCount(),
-            s_xEdfTasks[taskIndex].jobCount,
-            tempValue);
-        fflush(stdout);
+// Opens one event; the caller adds its own fields and the closing brace
+static void trace_event(const char* pcPhase, int tid, const char* pcName, uint32_t ulTime) {
+    fprintf(s_traceFile, ",\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"name\":", pcPhase, tid);
+    trace_string(pcName);
+    fprintf(s_traceFile, ",\"ts\":%.1f", trace_us(ulTime));
+    if (pcPhase[0] == 'i')
+        fprintf(s_traceFile, ",\"s\":\"t\"");
+    s_traceEvents++;
+}
 
-        // Increment job count for next iteration
-        s_xEdfTasks[taskIndex].jobCount++;
+static void trace_tracks(void) {
+    fprintf(s_traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"EDF demo\"}}");
+    for (int id = 0; id < EDF_TRACE_IDS; id++) {
+        if (id > s_numEdfTasks && id != EDF_TRACE_SCHEDULER && id != EDF_TRACE_LOGGER)
+            continue;
+        fprintf(s_traceFile, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\","
+            "\"args\":{\"name\":", id);
+        trace_string(trace_name(id));
+        fprintf(s_traceFile, "}}");
+        fprintf(s_traceFile, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_sort_index\","
+            "\"args\":{\"sort_index\":%d}}", id, id == EDF_TRACE_OTHER ? EDF_TRACE_IDS : id);
     }
 }
 
-static void vPressureTask_EDF(void* pvParameters) {
-    TickType_t xLastWakeTime;
-    const TickType_t xFrequency = pdMS_TO_TICKS(PRESSURE_TASK_PERIOD_MS);
-    int pressureValue;
-    int taskIndex = (int)pvParameters;
+// Jobs are slices on their task's track; everything else is an instant event
+static void trace_record(const EdfLogRecord_t* record) {
+    int tid = record->usTask + 1;
+    char name[32];
+
+    switch (record->ucEvent) {
+    case EDF_LOG_JOB_START:
+        snprintf(name, sizeof(name), "Job %lu", (unsigned long)record->ulJob);
+        trace_event("B", tid, name, record->ulTime);
+        fprintf(s_traceFile, ",\"args\":{\"deadline\":%lu}}", (unsigned long)record->xDeadline);
+        break;
+    case EDF_LOG_JOB_END:
+    case EDF_LOG_ABORT:
+        trace_event("E", tid, "", record->ulTime);
+        fprintf(s_traceFile, ",\"args\":{\"%s\":%ld}}",
+            record->ucEvent == EDF_LOG_ABORT ? "aborted" : "value", (long)record->lValue);
+        break;
+    case EDF_LOG_PRIORITY:
+        trace_event("i", tid, "Priority", record->ulTime);
+        fprintf(s_traceFile, ",\"args\":{\"from\":%d,\"to\":%ld}}", record->sExtra, (long)record->lValue);
+        break;
+    case EDF_LOG_PREEMPT:
+        trace_event("i", tid, "EDF preempt", record->ulTime);
+        fprintf(s_traceFile, ",\"args\":{\"victim\":");
+        trace_string(s_xEdfTasks[record->sExtra].pcTaskName);
+        fprintf(s_traceFile, "}}");
+        break;
+    case EDF_LOG_MISS:
+        trace_event("i", tid, "Deadline miss", record->ulTime);
+        fprintf(s_traceFile, ",\"args\":{\"job\":%lu,\"deadline\":%lu}}",
+            (unsigned long)record->ulJob, (unsigned long)record->xDeadline);
+        break;
+    case EDF_LOG_SKIP:
+        trace_event("i", tid, "Skip", record->ulTime);
+        fprintf(s_traceFile, ",\"args\":{\"job\":%lu}}", (unsigned long)record->ulJob);
+        break;
+    case EDF_LOG_WINDOW:
+        trace_event("i", tid, "Window", record->ulTime);
+        fprintf(s_traceFile, ",\"args\":{\"window\":%lu}}", (unsigned long)record->ulJob);
+        break;
+    default:
+        break;
+    }
+}
 
-    xLastWakeTime = xTaskGetTickCount();
+// A real context switch, shown on the track of the task switched in
+static void trace_switch(const EdfSwitchRecord_t* sw) {
+    trace_event("i", sw->ucTo, "CS", sw->ulTime);
+    fprintf(s_traceFile, ",\"args\":{\"from\":");
+    trace_string(trace_name(sw->ucFrom));
+    fprintf(s_traceFile, ",\"preempted\":%d}}", sw->ucPreempted);
+}
 
-    // Initialize job count
-    s_xEdfTasks[taskIndex].jobCount = 1;
+// Lowest-priority task that drains the ring while nothing else needs the CPU
+static void vEdfLoggerTask(void* pvParameters) {
+    EdfLogRecord_t previous = { 0 };
+    previous.ucEvent = EDF_LOG_END;
 
     for (;;) {
-        // Check if simulation is complete
-        if (s_simulationComplete) {
+        bool ended = false;
+
+        while (s_logTail != s_logHead) {
+            EdfLogRecord_t record = s_logRing[s_logTail % EDF_LOG_RING_SIZE];
+            s_logTail++;
+
+            if (record.ucEvent == EDF_LOG_END) {
+                ended = true;
+                break;
+            }
+            if (s_printEvents)
+                format_record(&record, &previous);
+            if (s_traceFile != NULL)
+                trace_record(&record);
+            previous = record;
+        }
+
+        while (s_switchTail != s_switchHead) {
+            EdfSwitchRecord_t sw = s_switchRing[s_switchTail % EDF_TRACE_RING_SIZE];
+            s_switchTail++;
+#if EDF_TRACE_LOG_SWITCHES
+            printf("[Switch] t=%.0f us %s -> %s (%s)\n",
+                sw.ulTime / (configRUN_TIME_COUNTER_HZ / 1e6), trace_name(sw.ucFrom), trace_name(sw.ucTo),
+                sw.ucPreempted ? "preempted" : "voluntary");
+#endif
+            if (s_traceFile != NULL)
+                trace_switch(&sw);
+        }
+        fflush(stdout);
+
+        if (ended) {
+            // Stop counting, or the summary would count its own switches
+            s_traceEnabled = false;
+            if (s_traceFile != NULL) {
+                fprintf(s_traceFile, "\n]}\n");
+                fclose(s_traceFile);
+                s_traceFile = NULL;
+            }
+            print_summary();
+            if (s_pxEndCallback != NULL)
+                s_pxEndCallback();
             vTaskDelete(NULL);
             return;
         }
+        vTaskDelay(pdMS_TO_TICKS(EDF_LOG_DRAIN_PERIOD_MS));
+    }
+}
+
+// Record a new band for a task; the kernel is told by apply_priority_updates()
+static void queue_priority(int taskIndex, UBaseType_t uxPriority) {
+    EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+    if (task->currentPriority == uxPriority)
+        return;
+
+    task->currentPriority = uxPriority;
+    if (!task->updateQueued) {
+        task->updateQueued = true;
+        s_priorityUpdates[(s_updateHead + s_updateCount++) % EDF_MAX_TASKS] = taskIndex;
+    }
+}
 
-        TickType_t xDeadlineForNextPeriod = xLastWakeTime + xFrequency;
+// The current job of taskIndex is past its deadline: count it once and apply
+// the task's overrun policy. Must be called with the heaps locked.
+static void handle_overrun(int taskIndex) {
+    EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+    if (task->jobMissed)
+        return;
+
+    task->jobMissed = true;
+    task->ulMisses++;
+    switch (task->ucOverrunPolicy) {
+    case EDF_OVERRUN_SKIP_NEXT:
+        task->skipNext = true;
+        break;
+    case EDF_OVERRUN_ABORT:
+        task->abortJob = true;
+        // fall through
+    case EDF_OVERRUN_DEMOTE:
+        // Out of the ranking, so a late job can no longer hold the top band
+        // and drag every later deadline down with it
+        if (s_jobHeap.pos[taskIndex] >= 0)
+            heap_remove(&s_jobHeap, taskIndex);
+        queue_priority(taskIndex, EDF_BASE_PRIORITY);
+        break;
+    default:
+        break;
+    }
+}
 
-        if (xSemaphoreTake(s_xEdfMutex, portMAX_DELAY) == pdTRUE) {
-            s_xEdfTasks[taskIndex].xNextDeadline = xDeadlineForNextPeriod;
-            xSemaphoreGive(s_xEdfMutex);
+// Apply the overrun policy to every released job whose deadline has passed.
+// Late jobs are the earliest in the heap, so only they are visited. Must be
+// called with the heaps locked; returns the number of new misses.
+static int check_deadlines(TickType_t now) {
+    int late[EDF_MAX_TASKS];
+    int lateCount = 0;
+    int pending[EDF_MAX_TASKS]; // Heap positions still to look at
+    int pendingCount = 0;
+
+    if (s_jobHeap.size > 0)
+        pending[pendingCount++] = 0;
+
+    while (pendingCount > 0) {
+        int pos = pending[--pendingCount];
+        int taskIndex = s_jobHeap.items[pos];
+        if (s_xEdfTasks[taskIndex].xNextDeadline >= now)
+            continue;
+
+        late[lateCount++] = taskIndex;
+        if (2 * pos + 1 < s_jobHeap.size)
+            pending[pendingCount++] = 2 * pos + 1;
+        if (2 * pos + 2 < s_jobHeap.size)
+            pending[pendingCount++] = 2 * pos + 2;
+    }
+
+    // handle_overrun() may take jobs out of the heap, so walk it first
+    int misses = 0;
+    for (int i = 0; i < lateCount; i++) {
+        if (!s_xEdfTasks[late[i]].jobMissed) {
+            handle_overrun(late[i]);
+            misses++;
         }
+    }
+    return misses;
+}
 
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+// Re-rank the released jobs against the heap and queue every band that
+// changed. Must be called with the heaps locked.
+static void rank_jobs(void) {
+    const UBaseType_t uxHighestEdfPriority = EDF_BASE_PRIORITY + EDF_PRIORITY_LEVELS - 1;
+    int ranked[EDF_PRIORITY_LEVELS];
+    int rankedCount = heap_earliest(&s_jobHeap, ranked, EDF_PRIORITY_LEVELS);
 
-        // Check if we've reached the hyperperiod
-        TickType_t currentTick = xTaskGetTickCount();
-        if (currentTick > s_hyperperiod) {
-            s_simulationComplete = true;
+    // 1. Assign priorities by rank, touching only tasks whose rank changed
+    for (int i = 0; i < rankedCount; i++) {
+        queue_priority(ranked[i], uxHighestEdfPriority - i);
+    }
+
+    // 2. Unfinished jobs pushed out of the ranked set share the lowest band;
+    //    finished ones are no longer in the job heap and keep their priority
+    for (int i = 0; i < s_rankedCount; i++) {
+        if (s_jobHeap.pos[s_ranked[i]] < 0)
+            continue;
+
+        bool stillRanked = false;
+        for (int j = 0; j < rankedCount; j++) {
+            if (ranked[j] == s_ranked[i]) {
+                stillRanked = true;
+                break;
+            }
+        }
+        if (!stillRanked) {
+            queue_priority(s_ranked[i], EDF_BASE_PRIORITY);
+        }
+    }
+
+    for (int i = 0; i < rankedCount; i++) {
+        s_ranked[i] = ranked[i];
+    }
+    s_rankedCount = rankedCount;
+}
+
+// Give queued tasks their new priorities and log the changes. Runs in task
+// context: the scheduler task, the timer daemon or a task finishing a job.
+static void apply_priority_updates(void) {
+    BaseType_t bPriorityChanged = pdFALSE;
+
+    for (;;) {
+        // Pop and set together, so a newer band for the same task can never be
+        // overwritten by an older one
+        taskENTER_CRITICAL();
+        if (s_updateCount == 0) {
+            taskEXIT_CRITICAL();
+            break;
+        }
+        int taskIndex = s_priorityUpdates[s_updateHead];
+        s_updateHead = (s_updateHead + 1) % EDF_MAX_TASKS;
+        s_updateCount--;
+
+        EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+        UBaseType_t previousPriority = task->appliedPriority;
+        UBaseType_t uxNewPriority = task->currentPriority;
+        TickType_t xDeadline = task->xNextDeadline;
+        task->updateQueued = false;
+        bool changed = task->xHandle != NULL && previousPriority != uxNewPriority;
+        if (changed) {
+            vTaskPrioritySet(task->xHandle, uxNewPriority);
+            task->appliedPriority = uxNewPriority;
+        }
+        taskEXIT_CRITICAL();
+
+        if (!changed)
             continue;
+
+        bPriorityChanged = pdTRUE;
+        log_event(EDF_LOG_PRIORITY, taskIndex, 0, xDeadline, (int32_t)uxNewPriority, (int32_t)previousPriority);
+    }
+
+    // Log Preemption / Context Switch Info
+    int ranked[EDF_PRIORITY_LEVELS];
+    taskENTER_CRITICAL();
+    int rankedCount = s_rankedCount;
+    for (int i = 0; i < rankedCount; i++) {
+        ranked[i] = s_ranked[i];
+    }
+    int pendingJobs = s_jobHeap.size;
+    bool oldHighestPending = s_highestPrioTaskIndex >= 0 && s_jobHeap.pos[s_highestPrioTaskIndex] >= 0;
+    taskEXIT_CRITICAL();
+
+    int newHighestIndex = rankedCount > 0 ? ranked[0] : -1;
+
+    if (bPriorityChanged) {
+        for (int i = 0; i < rankedCount; i++) {
+            int idx = ranked[i];
+            log_event(EDF_LOG_ORDER, idx, (uint32_t)rankedCount, (TickType_t)(pendingJobs - rankedCount),
+                (int32_t)s_xEdfTasks[idx].currentPriority, i);
         }
 
-        UBaseType_t currentPriority = uxTaskPriorityGet(NULL);
+        // Check if the highest priority task changed -> likely preemption
+        if (newHighestIndex != s_highestPrioTaskIndex &&
+            newHighestIndex >= 0 &&
+            oldHighestPending) {
+            log_event(EDF_LOG_PREEMPT, newHighestIndex, 0, 0, 0, s_highestPrioTaskIndex);
+        }
+    }
 
-        printf("[%-12s] Tick=%-5lu START Job %d (Deadline:%lu)\n",
-            s_xEdfTasks[taskIndex].pcTaskName,
-            (unsigned long)currentTick,
-            s_xEdfTasks[taskIndex].jobCount,
-            (unsigned long)xDeadlineForNextPeriod);
-        fflush(stdout);
+    // Update the tracked highest priority task for the next cycle
+    s_highestPrioTaskIndex = newHighestIndex;
+}
 
-        pressureValue = getPressure();
+// Wake the scheduler so it re-ranks the tasks straight away
+static void notify_scheduler(void) {
+#if EDF_SCHEDULER_MODE == EDF_MODE_NOTIFY
+    // The scheduler clears its handle before deleting itself at the end of the run
+    taskENTER_CRITICAL();
+    if (s_xEdfSchedulerHandle != NULL) {
+        xTaskNotifyGive(s_xEdfSchedulerHandle);
+    }
+    taskEXIT_CRITICAL();
+#endif
+}
 
-        printf("[%-12s] Tick=%-5lu END Job %d (Value:%d)\n",
-            s_xEdfTasks[taskIndex].pcTaskName,
-            (unsigned long)xTaskGetTickCount(),
-            s_xEdfTasks[taskIndex].jobCount,
-            pressureValue);
-        fflush(stdout);
+// Set a task's own priority, keeping the EDF bookkeeping in step. Call inside
+// a critical section.
+static void set_own_priority(EdfTaskInfo_t* task, UBaseType_t uxPriority) {
+    task->currentPriority = uxPriority;
+    task->appliedPriority = uxPriority;
+    vTaskPrioritySet(NULL, uxPriority);
+}
 
-        // Increment job count for next iteration
-        s_xEdfTasks[taskIndex].jobCount++;
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+// A job of taskIndex was released at xRelease with the given absolute deadline
+static void release_job(int taskIndex, TickType_t xRelease, TickType_t xDeadline) {
+    EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+
+    taskENTER_CRITICAL();
+    task->ulReleaseTime = counter_at_tick(xRelease, xTaskGetTickCount());
+    task->xNextDeadline = xDeadline;
+    heap_insert(&s_jobHeap, taskIndex);
+    // Drop to the shared bottom band until the scheduler ranks the job. Both the
+    // priority change and the notification only take effect when the critical
+    // section ends, and the scheduler then runs first.
+    set_own_priority(task, EDF_BASE_PRIORITY);
+    notify_scheduler();
+    taskEXIT_CRITICAL();
+}
+#endif
+
+// Called by a task on its own job: catch a miss the scheduler has not seen
+// yet. Returns true if the job is to be given up.
+static bool check_own_deadline(int taskIndex, TickType_t xDeadline) {
+    EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+
+    taskENTER_CRITICAL();
+    bool newMiss = !task->jobMissed && xTaskGetTickCount() > xDeadline;
+    if (newMiss) {
+        handle_overrun(taskIndex);
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+        rank_jobs();
+#endif
+    }
+    bool abortJob = task->abortJob;
+    taskEXIT_CRITICAL();
+
+    // Let a demotion take effect now rather than when the job completes
+    if (newMiss) {
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+        apply_priority_updates();
+#else
+        notify_scheduler();
+#endif
     }
+    return abortJob;
 }
 
-static void vHeightTask_EDF(void* pvParameters) {
-    TickType_t xLastWakeTime;
-    const TickType_t xFrequency = pdMS_TO_TICKS(HEIGHT_TASK_PERIOD_MS);
-    int heightValue;
-    int taskIndex = (int)pvParameters;
+// The current job of taskIndex finished; returns true if the task's next
+// release is dropped after an overrun
+static bool complete_job(int taskIndex) {
+    EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+
+    taskENTER_CRITICAL();
+    // Demoted and aborted jobs have already left the heap
+    if (s_jobHeap.pos[taskIndex] >= 0)
+        heap_remove(&s_jobHeap, taskIndex);
+    bool skipNext = task->skipNext;
+    task->jobMissed = false;
+    task->abortJob = false;
+    task->skipNext = false;
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+    if (skipNext)
+        task->xNextRelease += task->xPeriodTicks;
+    // The tick hook releases the next job; promote whoever is next right away
+    heap_insert(&s_releaseHeap, taskIndex);
+    rank_jobs();
+    taskEXIT_CRITICAL();
+    apply_priority_updates();
+#else
+    // Wait for the next release above every EDF band so that release preempts
+    // whatever is running
+    set_own_priority(task, EDF_RELEASE_PRIORITY);
+    notify_scheduler();
+    taskEXIT_CRITICAL();
+#endif
+    return skipNext;
+}
 
-    xLastWakeTime = xTaskGetTickCount();
+// --- Sensor pipeline jobs ---
+static int publish_sample(SensorType_t sensor) {
+    EdfSensorRing_t* ring = &s_sensorRings[sensor];
+    uint32_t head = ring->head;
+    if (head - ring->tail == EDF_SENSOR_RING_SIZE) {
+        ring->ulDropped++;
+        return 0;
+    }
 
-    // Initialize job count
-    s_xEdfTasks[taskIndex].jobCount = 1;
+    uint32_t slot = head % EDF_SENSOR_RING_SIZE;
+    getSensorSamples(sensor, &ring->values[slot], 1);
+    ring->xTicks[slot] = xTaskGetTickCount();
+    ring->ulTimes[slot] = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+    ring->ulPublished++;
+    // One core: the slot only has to be written before head, as the compiler sees it
+    edf_compiler_barrier();
+    ring->head = head + 1;
+    return ring->values[slot];
+}
+
+static int publish_temperature(void) {
+    return publish_sample(SENSOR_TEMPERATURE);
+}
+
+static int publish_pressure(void) {
+    return publish_sample(SENSOR_PRESSURE);
+}
+
+static int publish_height(void) {
+    return publish_sample(SENSOR_HEIGHT);
+}
+
+// Fuses everything published since the last window; returns the samples used
+static int aggregate_sensors(void) {
+    EdfSensorWindow_t* window = &s_sensorWindows[s_sensorWindowCount % EDF_SENSOR_WINDOW_SLOTS];
+    uint32_t ulOldest = 0;
+    uint32_t ulNewest = 0;
+    bool any = false;
+    int samples = 0;
+
+    window->ulWindow = s_sensorWindowCount;
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+        EdfSensorRing_t* ring = &s_sensorRings[i];
+        EdfStreamStats_t* stream = &window->xStreams[i];
+        uint32_t tail = ring->tail;
+        uint32_t head = ring->head;
+        edf_compiler_barrier();
+
+        *stream = (EdfStreamStats_t){ 0 };
+        for (uint32_t n = tail; n != head; n++) {
+            uint32_t slot = n % EDF_SENSOR_RING_SIZE;
+            int value = ring->values[slot];
+            if (stream->ulCount == 0 || value < stream->lMin)
+                stream->lMin = value;
+            if (stream->ulCount == 0 || value > stream->lMax)
+                stream->lMax = value;
+            stream->llSum += value;
+            stream->ulCount++;
+
+            if (!any || (int32_t)(ring->ulTimes[slot] - ulOldest) < 0)
+                ulOldest = ring->ulTimes[slot];
+            if (!any || (int32_t)(ring->ulTimes[slot] - ulNewest) > 0)
+                ulNewest = ring->ulTimes[slot];
+            any = true;
+
+            // The first run has no earlier sample; its rate starts at its own first one
+            if (!s_haveLast[i]) {
+                s_lastValue[i] = value;
+                s_lastTick[i] = ring->xTicks[slot];
+                s_haveLast[i] = true;
+            }
+        }
+        if (stream->ulCount > 0) {
+            uint32_t slot = (head - 1) % EDF_SENSOR_RING_SIZE;
+            TickType_t xElapsed = ring->xTicks[slot] - s_lastTick[i];
+            if (xElapsed > 0) {
+                stream->fRate = (float)(ring->values[slot] - s_lastValue[i]) * 1000.0f /
+                    (float)(xElapsed * EDF_MS_PER_TICK);
+            }
+            s_lastValue[i] = ring->values[slot];
+            s_lastTick[i] = ring->xTicks[slot];
+        }
+        // Slots go back to the sensor task only once they have been read
+        edf_compiler_barrier();
+        ring->tail = head;
+
+        EdfStreamStats_t* total = &s_streamTotals[i];
+        if (stream->ulCount > 0) {
+            if (total->ulCount == 0 || stream->lMin < total->lMin)
+                total->lMin = stream->lMin;
+            if (total->ulCount == 0 || stream->lMax > total->lMax)
+                total->lMax = stream->lMax;
+            total->llSum += stream->llSum;
+            total->ulCount += stream->ulCount;
+        }
+        samples += (int)stream->ulCount;
+    }
+
+    uint32_t now = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+    window->ulOldestAge = any ? now - ulOldest : 0;
+    window->ulNewestAge = any ? now - ulNewest : 0;
+    if (any)
+        histogram_add(&s_dataAge, window->ulOldestAge);
+    log_event(EDF_LOG_WINDOW, s_aggregatorTask, s_sensorWindowCount, 0, 0, 0);
+    s_sensorWindowCount++;
+    return samples;
+}
+
+// The job of task `to` starts or resumes after the one of s_lastEdfId
+static void count_edf_switch(int to) {
+    if (s_lastEdfId != EDF_TRACE_OTHER && s_lastEdfId != to) {
+        s_edfSwitches++;
+        if (s_lastEdfPreempted)
+            s_edfPreemptions++;
+    }
+    s_lastEdfId = to;
+}
+
+// --- Periodic task runner shared by every table entry ---
+static void vPeriodicTask_EDF(void* pvParameters) {
+    int taskIndex = (int)(intptr_t)pvParameters;
+    EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+#endif
 
     for (;;) {
         // Check if simulation is complete
         if (s_simulationComplete) {
+            taskENTER_CRITICAL();
+            capture_task_stats(task);
+            task->xHandle = NULL;
+            taskEXIT_CRITICAL();
             vTaskDelete(NULL);
             return;
         }
 
-        TickType_t xDeadlineForNextPeriod = xLastWakeTime + xFrequency;
-
-        if (xSemaphoreTake(s_xEdfMutex, portMAX_DELAY) == pdTRUE) {
-            s_xEdfTasks[taskIndex].xNextDeadline = xDeadlineForNextPeriod;
-            xSemaphoreGive(s_xEdfMutex);
-        }
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+        // The tick hook releases the job, already ranked, with its deadline set
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (s_simulationComplete)
+            continue;
+        TickType_t xJobDeadline = task->xNextDeadline;
+#else
+        vTaskDelayUntil(&xLastWakeTime, task->xPeriodTicks);
 
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+        // --- Job Execution START ---
+        TickType_t currentTick = xTaskGetTickCount();
 
         // Check if we've reached the hyperperiod
-        TickType_t currentTick = xTaskGetTickCount();
-        if (currentTick > s_hyperperiod) {
+        if (currentTick > s_simulationEnd) {
             s_simulationComplete = true;
             continue;
         }
 
-        UBaseType_t currentPriority = uxTaskPriorityGet(NULL);
+        // The job released at xLastWakeTime is due one relative deadline later
+        TickType_t xJobDeadline = xLastWakeTime + task->xRelativeDeadlineTicks;
+        release_job(taskIndex, xLastWakeTime, xJobDeadline);
+#endif
 
-        printf("[%-12s] Tick=%-5lu START Job %d (Deadline:%lu)\n",
-            s_xEdfTasks[taskIndex].pcTaskName,
-            (unsigned long)currentTick,
-            s_xEdfTasks[taskIndex].jobCount,
-            (unsigned long)xDeadlineForNextPeriod);
-        fflush(stdout);
+        log_event(EDF_LOG_JOB_START, taskIndex, (uint32_t)task->jobCount, xJobDeadline, 0, 0);
+        // The job may start right after the release bookkeeping, without a
+        // switch at its ranked band
+        taskENTER_CRITICAL();
+        if (s_traceEnabled)
+            count_edf_switch(taskIndex + 1);
+        taskEXIT_CRITICAL();
 
-        heightValue = getHeight();
+        // --- Perform Task Work ---
+        // Abort acts only here, at the job boundary: an aborting task does not
+        // start a job that is already late, but one that started runs to the
+        // end (demoted) and counts as a completed miss
+        int value = 0;
+        bool aborted = check_own_deadline(taskIndex, xJobDeadline);
+        if (!aborted) {
+            value = task->pxJob();
+            check_own_deadline(taskIndex, xJobDeadline);
+        }
 
-        printf("[%-12s] Tick=%-5lu END Job %d (Value:%d)\n",
-            s_xEdfTasks[taskIndex].pcTaskName,
-            (unsigned long)xTaskGetTickCount(),
-            s_xEdfTasks[taskIndex].jobCount,
-            heightValue);
-        fflush(stdout);
+        // --- Job Execution END ---
+        if (task->jobMissed) {
+            log_event(EDF_LOG_MISS, taskIndex, (uint32_t)task->jobCount, xJobDeadline, 0, task->ucOverrunPolicy);
+        }
+        if (aborted) {
+            task->ulAborted++;
+            log_event(EDF_LOG_ABORT, taskIndex, (uint32_t)task->jobCount, xJobDeadline, 0, 0);
+        }
+        else {
+            histogram_add(&task->xResponse, (uint32_t)portGET_RUN_TIME_COUNTER_VALUE() - task->ulReleaseTime);
+            log_event(EDF_LOG_JOB_END, taskIndex, (uint32_t)task->jobCount, xJobDeadline, value, 0);
+        }
 
         // Increment job count for next iteration
-        s_xEdfTasks[taskIndex].jobCount++;
+        task->jobCount++;
+
+        if (complete_job(taskIndex)) {
+            // Skipped jobs keep their number so job N is still the Nth release
+            task->ulSkipped++;
+            log_event(EDF_LOG_SKIP, taskIndex, (uint32_t)task->jobCount, 0, 0, 0);
+            task->jobCount++;
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+            xLastWakeTime += task->xPeriodTicks;
+#endif
+        }
     }
 }
 
-// EDF Scheduler Task (Improved Logging)
-static void vEdfSchedulerTask_EDF(void* pvParameters) {
-    TickType_t xLastCheckTime;
-    const TickType_t xCheckFrequency = pdMS_TO_TICKS(EDF_CHECK_PERIOD_MS);
-    const UBaseType_t uxHighestEdfPriority = EDF_BASE_PRIORITY + NUM_EDF_TASKS - 1;
-    int sortedIndices[NUM_EDF_TASKS];
-    BaseType_t bPriorityChanged = pdFALSE;
-    TaskHandle_t xCurrentHighestTaskHandle = NULL;
-
+static void print_banner(void) {
     printf("\n===== EDF SCHEDULING SIMULATION =====\n");
     printf("Task Information:\n");
-    printf("- TempTask:     Period=%lu ms\n", (unsigned long)TEMP_TASK_PERIOD_MS);
-    printf("- PressureTask: Period=%lu ms\n", (unsigned long)PRESSURE_TASK_PERIOD_MS);
-    printf("- HeightTask:   Period=%lu ms\n", (unsigned long)HEIGHT_TASK_PERIOD_MS);
+    for (int i = 0; i < s_numEdfTasks; i++) {
+        printf("- %-13s Period=%lu ms Deadline=%lu ms Overrun=%s\n",
+            s_xEdfTasks[i].pcTaskName,
+            (unsigned long)s_xEdfTasks[i].xPeriodTicks * EDF_MS_PER_TICK,
+            (unsigned long)s_xEdfTasks[i].xRelativeDeadlineTicks * EDF_MS_PER_TICK,
+            overrun_policy_name(s_xEdfTasks[i].ucOverrunPolicy));
+    }
     printf("Hyperperiod: %lu ticks\n", (unsigned long)s_hyperperiod);
+    if (s_runHyperperiods > 1)
+        printf("Running %lu hyperperiods (%lu ticks)\n", (unsigned long)s_runHyperperiods, (unsigned long)s_simulationEnd);
     printf("=====================================\n\n");
+}
 
-    printf("[Scheduler] Tick=%-5lu EDF Scheduler Started\n", (unsigned long)xTaskGetTickCount());
-    fflush(stdout);
+static void print_summary(void) {
+    if (s_runHyperperiods > 1)
+        printf("\n----- END OF SIMULATION (Hyperperiod: %lu, %lu hyperperiods) -----\n",
+            (unsigned long)s_hyperperiod, (unsigned long)s_runHyperperiods);
+    else
+        printf("\n----- END OF SIMULATION (Hyperperiod: %lu) -----\n", (unsigned long)s_hyperperiod);
+    printf("\nEDF Schedule Summary:\n");
+
+    // Print a simple summary of the schedule
+    printf("The EDF algorithm scheduled tasks based on earliest deadline:\n");
+    printf("- Tasks with earlier deadlines received higher priorities\n");
+    printf("- Preemption occurred when a task with an earlier deadline became ready\n");
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+    printf("- Releases and ranking ran in the tick hook: %lu ticks, %lu releases, "
+        "avg %.1f us, max %.1f us per tick\n",
+        s_hookTicks, s_hookReleases,
+        s_hookTicks ? (double)s_hookTotal / s_hookTicks / (configRUN_TIME_COUNTER_HZ / 1e6) : 0.0,
+        s_hookMax / (configRUN_TIME_COUNTER_HZ / 1e6));
+#else
+    printf("- Scheduler woke %lu times (%s)\n", s_schedulerWakeups,
+        EDF_SCHEDULER_MODE == EDF_MODE_POLLING ? "polling" : "on job release/completion");
+#endif
+
+    // Deadline accounting; jobCount starts at 1 and also counts skipped releases
+    unsigned long jobs = 0, misses = 0, aborted = 0, skipped = 0;
+    for (int i = 0; i < s_numEdfTasks; i++) {
+        jobs += (unsigned long)(s_xEdfTasks[i].jobCount - 1) - s_xEdfTasks[i].ulSkipped;
+        misses += s_xEdfTasks[i].ulMisses;
+        aborted += s_xEdfTasks[i].ulAborted;
+        skipped += s_xEdfTasks[i].ulSkipped;
+    }
+    printf("- Deadline misses: %lu of %lu jobs (%lu aborted, %lu releases skipped)\n",
+        misses, jobs, aborted, skipped);
+    for (int i = 0; i < s_numEdfTasks; i++) {
+        if (s_xEdfTasks[i].ulMisses > 0) {
+            printf("  - %-12s: %lu missed (%s)\n", s_xEdfTasks[i].pcTaskName,
+                (unsigned long)s_xEdfTasks[i].ulMisses, overrun_policy_name(s_xEdfTasks[i].ucOverrunPolicy));
+        }
+    }
 
-    xLastCheckTime = xTaskGetTickCount();
+    // Measured with the run-time counter; percentages are of the whole run
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+    // The deferred updates run in the timer daemon, which has little else to do
+    TaskStatus_t xStatus;
+    vTaskGetInfo(xTimerGetTimerDaemonTaskHandle(), &xStatus, pdFALSE, eInvalid);
+    s_schedulerCpuTime = xStatus.ulRunTimeCounter;
+#endif
+    const double counterPerUs = configRUN_TIME_COUNTER_HZ / 1e6;
+    const double runCounts = (double)s_simulationEnd * (configRUN_TIME_COUNTER_HZ / configTICK_RATE_HZ);
+    printf("- Scheduler cost per invocation (us): %lu runs, min %.1f avg %.1f max %.1f, "
+        "%.3f per tick, CPU %.0f us (%.2f%%)\n",
+        (unsigned long)s_schedulerCost.ulCount,
+        s_schedulerCost.ulMin / counterPerUs,
+        s_schedulerCost.ulCount ? (double)s_schedulerCost.ullTotal / s_schedulerCost.ulCount / counterPerUs : 0.0,
+        s_schedulerCost.ulMax / counterPerUs,
+        s_simulationEnd ? (double)s_schedulerCost.ullTotal / s_simulationEnd / counterPerUs : 0.0,
+        s_schedulerCpuTime / counterPerUs, 100.0 * s_schedulerCpuTime / runCounts);
+    print_histogram(&s_schedulerCost);
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+    printf("- Stack unused: EDFSched %lu of %d words, EDFLog %lu of %d words\n",
+        (unsigned long)s_schedulerStackFree, EDF_SCHEDULER_STACK_SIZE,
+        (unsigned long)uxTaskGetStackHighWaterMark(NULL), EDF_LOGGER_STACK_SIZE);
+#else
+    printf("- Stack unused: EDFLog %lu of %d words\n",
+        (unsigned long)uxTaskGetStackHighWaterMark(NULL), EDF_LOGGER_STACK_SIZE);
+#endif
+
+    printf("- Response time per task (us) and CPU time:\n");
+    for (int i = 0; i < s_numEdfTasks; i++) {
+        EdfTaskInfo_t* task = &s_xEdfTasks[i];
+        taskENTER_CRITICAL();
+        capture_task_stats(task);
+        taskEXIT_CRITICAL();
+
+        printf("  - %-12s: %lu jobs, min %.1f avg %.1f max %.1f, CPU %.0f us (%.2f%%), "
+            "stack %lu of %u words unused\n",
+            task->pcTaskName, (unsigned long)task->xResponse.ulCount,
+            task->xResponse.ulMin / counterPerUs,
+            task->xResponse.ulCount ? (double)task->xResponse.ullTotal / task->xResponse.ulCount / counterPerUs : 0.0,
+            task->xResponse.ulMax / counterPerUs,
+            task->ulCpuTime / counterPerUs, 100.0 * task->ulCpuTime / runCounts,
+            (unsigned long)task->uxStackFree, (unsigned)task->usStackDepth);
+        print_histogram(&task->xResponse);
+    }
 
-    // Keep track of the current execution sequence for Gantt chart
-    printf("\n----- EDF EXECUTION SEQUENCE -----\n");
+    // Exact figures from the kernel's switch hooks
+    unsigned long switchesPreempted = 0, switchesYielded = 0;
+    for (int from = 0; from < EDF_TRACE_IDS; from++) {
+        for (int to = 0; to < EDF_TRACE_IDS; to++) {
+            switchesPreempted += s_switchPairs[from][to].ulPreempted;
+            switchesYielded += s_switchPairs[from][to].ulYielded;
+        }
+    }
+    printf("- Context switches (kernel trace): %lu, %lu preemptions, %lu voluntary; %lu trace records dropped\n",
+        switchesPreempted + switchesYielded, switchesPreempted, switchesYielded, (unsigned long)s_switchDropped);
+    printf("- Switches between EDF tasks (as context_switches in Part 2): %lu, %lu of them preemptions\n",
+        (unsigned long)s_edfSwitches, (unsigned long)s_edfPreemptions);
+    printf("- Switches per task pair (preempted/voluntary):\n");
+    for (int from = 0; from < EDF_TRACE_IDS; from++) {
+        for (int to = 0; to < EDF_TRACE_IDS; to++) {
+            const EdfSwitchCount_t* pair = &s_switchPairs[from][to];
+            if (pair->ulPreempted + pair->ulYielded == 0)
+                continue;
+            printf("  - %-12s -> %-12s: %lu/%lu\n", trace_name(from), trace_name(to),
+                (unsigned long)pair->ulPreempted, (unsigned long)pair->ulYielded);
+        }
+    }
 
-    for (;;) {
-        vTaskDelayUntil(&xLastCheckTime, xCheckFrequency);
-        TickType_t currentTick = xTaskGetTickCount();
+    if (s_aggregatorTask >= 0) {
+        printf("- Sensor pipeline: %lu windows, data age (us) min %.1f avg %.1f max %.1f\n",
+            (unsigned long)s_sensorWindowCount, s_dataAge.ulMin / counterPerUs,
+            s_dataAge.ulCount ? (double)s_dataAge.ullTotal / s_dataAge.ulCount / counterPerUs : 0.0,
+            s_dataAge.ulMax / counterPerUs);
+        print_histogram(&s_dataAge);
+        for (int i = 0; i < SENSOR_COUNT; i++) {
+            const EdfStreamStats_t* total = &s_streamTotals[i];
+            printf("  - %-8s: %lu published, %lu fused, %lu dropped, mean %.1f min %d max %d\n",
+                s_sensorNames[i], (unsigned long)s_sensorRings[i].ulPublished,
+                (unsigned long)total->ulCount, (unsigned long)s_sensorRings[i].ulDropped,
+                total->ulCount ? (double)total->llSum / total->ulCount : 0.0, total->lMin, total->lMax);
+        }
+    }
 
-        // Check if simulation is complete
-        if (s_simulationComplete || currentTick > s_hyperperiod) {
-            printf("\n----- END OF SIMULATION (Hyperperiod: %lu) -----\n", (unsigned long)s_hyperperiod);
-            printf("\nEDF Schedule Summary:\n");
+    printf("- Log: %lu records, %lu dropped, ring high-water mark %lu of %d\n",
+        (unsigned long)s_logWritten, (unsigned long)s_logDropped,
+        (unsigned long)s_logHighWater, EDF_LOG_RING_SIZE);
+    if (s_traceEvents > 0)
+        printf("- Trace: %lu events exported\n", (unsigned long)s_traceEvents);
 
-            // Print a simple summary of the schedule
-            printf("The EDF algorithm scheduled tasks based on earliest deadline:\n");
-            printf("- Tasks with earlier deadlines received higher priorities\n");
-            printf("- Preemption occurred when a task with an earlier deadline became ready\n");
+    printf("\nSimulation complete.\n");
+    fflush(stdout);
+}
 
-            printf("\nSimulation complete.\n");
-            fflush(stdout);
+// Runs inside vTaskSwitchContext(), just before the next task is chosen
+void vEdfTraceSwitchedOut(void* pvTask, void* pvTaskTag, long lStillReady) {
+    s_switchedOutTask = pvTask;
+    s_switchedOutId = (uint8_t)(uintptr_t)pvTaskTag;
+    s_switchedOutPreempted = lStillReady != 0;
+}
 
-            s_simulationComplete = true;
-            vTaskDelete(NULL);
-            return;
-        }
+// Runs inside vTaskSwitchContext() once the next task is chosen
+void vEdfTraceSwitchedIn(void* pvTask, void* pvTaskTag, unsigned long ulPriority) {
+    // The kernel may pick the task that was already running; the first task
+    // of all is switched in without a switch out
+    if (!s_traceEnabled || s_switchedOutTask == NULL || pvTask == s_switchedOutTask)
+        return;
+
+    uint8_t from = s_switchedOutId;
+    uint8_t to = (uint8_t)(uintptr_t)pvTaskTag;
+    if (s_switchedOutPreempted)
+        s_switchPairs[from][to].ulPreempted++;
+    else
+        s_switchPairs[from][to].ulYielded++;
+
+    // A task woken at EDF_RELEASE_PRIORITY only does release bookkeeping and
+    // then drops back, so neither that switch nor the one back is counted
+    if (from == s_lastEdfId)
+        s_lastEdfPreempted = s_switchedOutPreempted;
+    if (to >= 1 && to <= EDF_MAX_TASKS && ulPriority < EDF_RELEASE_PRIORITY)
+        count_edf_switch(to);
+
+    uint32_t head = s_switchHead;
+    if (head - s_switchTail == EDF_TRACE_RING_SIZE) {
+        s_switchDropped++;
+    }
+    else {
+        s_switchRing[head % EDF_TRACE_RING_SIZE] = (EdfSwitchRecord_t){
+            (uint32_t)portGET_RUN_TIME_COUNTER_VALUE(), from, to, (uint8_t)s_switchedOutPreempted
+        };
+        s_switchHead = head + 1;
+    }
+}
 
-        bPriorityChanged = pdFALSE;
-        xCurrentHighestTaskHandle = NULL;
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+// Runs in the timer daemon task, queued from the tick hook
+static void prvApplyDeferredUpdates(void* pvParameter1, uint32_t ulParameter2) {
+    uint32_t ulStart = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+    taskENTER_CRITICAL();
+    s_applyPending = false;
+    taskEXIT_CRITICAL();
+    apply_priority_updates();
+    histogram_add(&s_schedulerCost, (uint32_t)portGET_RUN_TIME_COUNTER_VALUE() - ulStart);
+}
 
-        if (xSemaphoreTake(s_xEdfMutex, portMAX_DELAY) == pdTRUE) {
-            // 1. Populate index array & update current priorities in struct
-            for (int i = 0; i < NUM_EDF_TASKS; i++) {
-                sortedIndices[i] = i;
-                if (s_xEdfTasks[i].xHandle != NULL) {
-                    s_xEdfTasks[i].currentPriority = uxTaskPriorityGet(s_xEdfTasks[i].xHandle);
-                }
-                else {
-                    s_xEdfTasks[i].currentPriority = 0;
-                }
-            }
+static void prvEndSimulation(void* pvParameter1, uint32_t ulParameter2) {
+    // The logger prints the summary once everything before it is out
+    log_event(EDF_LOG_END, 0, 0, 0, 0, 0);
 
-            // 2. Sort indices based on deadline in s_xEdfTasks (Bubble Sort)
-            for (int i = 0; i < NUM_EDF_TASKS - 1; i++) {
-                for (int j = 0; j < NUM_EDF_TASKS - i - 1; j++) {
-                    // Compare deadlines
-                    if (s_xEdfTasks[sortedIndices[j]].xNextDeadline > s_xEdfTasks[sortedIndices[j + 1]].xNextDeadline) {
-                        int temp = sortedIndices[j];
-                        sortedIndices[j] = sortedIndices[j + 1];
-                        sortedIndices[j + 1] = temp;
-                    }
-                    else if (s_xEdfTasks[sortedIndices[j]].xNextDeadline == s_xEdfTasks[sortedIndices[j + 1]].xNextDeadline) {
-                        // Tie-break by index (lower index = higher effective prio in tie)
-                        if (sortedIndices[j] > sortedIndices[j + 1]) {
-                            int temp = sortedIndices[j];
-                            sortedIndices[j] = sortedIndices[j + 1];
-                            sortedIndices[j + 1] = temp;
-                        }
-                    }
-                }
-            }
+    // Wake every waiting task so it sees the flag and deletes itself
+    for (int i = 0; i < s_numEdfTasks; i++) {
+        taskENTER_CRITICAL();
+        if (s_xEdfTasks[i].xHandle != NULL) {
+            xTaskNotifyGive(s_xEdfTasks[i].xHandle);
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+#endif
+
+// Called from vApplicationTickHook(), i.e. inside the tick interrupt: releases
+// due jobs and re-ranks them. vTaskPrioritySet() is not interrupt safe, so the
+// priority changes are handed to the timer daemon task.
+void vEdfTickHook(void) {
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+    if (s_numEdfTasks == 0 || s_simulationComplete)
+        return;
+
+    uint32_t ulStart = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+    TickType_t currentTick = xTaskGetTickCountFromISR();
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+    if (currentTick > s_simulationEnd) {
+        s_simulationComplete = true;
+        taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+        xTimerPendFunctionCallFromISR(prvEndSimulation, NULL, 0, NULL);
+        return;
+    }
 
-            // 3. Assign Priorities & Log Changes/Preemptions
-            TaskHandle_t xNewHighestTaskHandle = NULL;
+    // Release every due job, at most EDF_HOOK_MAX_RELEASES_PER_TICK of them;
+    // the rest stay at the top of the heap for the next tick
+    int releases = 0;
+    while (releases < EDF_HOOK_MAX_RELEASES_PER_TICK && s_releaseHeap.size > 0 &&
+        s_xEdfTasks[s_releaseHeap.items[0]].xNextRelease <= currentTick) {
+        int taskIndex = s_releaseHeap.items[0];
+        EdfTaskInfo_t* task = &s_xEdfTasks[taskIndex];
+
+        heap_remove(&s_releaseHeap, taskIndex);
+        task->ulReleaseTime = counter_at_tick(task->xNextRelease, currentTick);
+        task->xNextDeadline = task->xNextRelease + task->xRelativeDeadlineTicks;
+        task->xNextRelease += task->xPeriodTicks;
+        heap_insert(&s_jobHeap, taskIndex);
+        // New jobs start in the shared bottom band unless ranked higher below
+        queue_priority(taskIndex, EDF_BASE_PRIORITY);
+
+        // A NULL woken flag makes the kernel switch at the end of this tick
+        vTaskNotifyGiveFromISR(task->xHandle, NULL);
+        releases++;
+    }
 
-            for (int i = 0; i < NUM_EDF_TASKS; i++) {
-                UBaseType_t uxNewPriority = uxHighestEdfPriority - i;
-                int actualTaskIndex = sortedIndices[i];
-                TaskHandle_t taskToChange = s_xEdfTasks[actualTaskIndex].xHandle;
+    // Overruns are found on the tick after the deadline
+    int misses = check_deadlines(currentTick);
 
-                if (taskToChange == NULL || eTaskGetState(taskToChange) == eDeleted)
-                    continue;
+    if (releases > 0 || misses > 0) {
+        rank_jobs();
+        if (s_updateCount > 0 && !s_applyPending) {
+            s_applyPending = true;
+            xTimerPendFunctionCallFromISR(prvApplyDeferredUpdates, NULL, 0, NULL);
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+    uint32_t elapsed = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+    s_hookTicks++;
+    s_hookReleases += releases;
+    s_hookTotal += elapsed;
+    if (elapsed > s_hookMax)
+        s_hookMax = elapsed;
+#endif
+}
 
-                // Store the handle of the task that should have the highest priority now
-                if (i == 0) {
-                    xNewHighestTaskHandle = taskToChange;
-                }
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+// EDF Scheduler Task (Improved Logging)
+static void vEdfSchedulerTask_EDF(void* pvParameters) {
+#if EDF_SCHEDULER_MODE == EDF_MODE_POLLING
+    TickType_t xLastCheckTime;
+    const TickType_t xCheckFrequency = pdMS_TO_TICKS(EDF_CHECK_PERIOD_MS);
+#endif
 
-                // Update stored priority and check if actual priority needs setting
-                UBaseType_t previousStoredPriority = s_xEdfTasks[actualTaskIndex].currentPriority;
-                s_xEdfTasks[actualTaskIndex].currentPriority = uxNewPriority;
+    print_banner();
 
-                if (uxTaskPriorityGet(taskToChange) != uxNewPriority) {
-                    vTaskPrioritySet(taskToChange, uxNewPriority);
+    printf("[Scheduler] Tick=%-5lu EDF Scheduler Started\n", (unsigned long)xTaskGetTickCount());
+    fflush(stdout);
 
-                    if (!bPriorityChanged) {
-                        printf("[Scheduler] Tick=%-5lu Priority Updates:\n", currentTick);
-                        bPriorityChanged = pdTRUE;
-                    }
+#if EDF_SCHEDULER_MODE == EDF_MODE_POLLING
+    xLastCheckTime = xTaskGetTickCount();
+#endif
 
-                    printf("  - %-12s: %lu -> %lu (Deadline: %lu)\n",
-                        s_xEdfTasks[actualTaskIndex].pcTaskName,
-                        (unsigned long)previousStoredPriority,
-                        (unsigned long)uxNewPriority,
-                        (unsigned long)s_xEdfTasks[actualTaskIndex].xNextDeadline);
-                }
-            }
+    // Keep track of the current execution sequence for Gantt chart
+    printf("\n----- EDF EXECUTION SEQUENCE -----\n");
 
-            // 4. Log Preemption / Context Switch Info
-            if (bPriorityChanged) {
-                printf("  New Priority Order: ");
-                for (int i = 0; i < NUM_EDF_TASKS; i++) {
-                    int idx = sortedIndices[i];
-                    if (s_xEdfTasks[idx].xHandle == NULL)
-                        continue;
-                    printf("%s(%lu)%s",
-                        s_xEdfTasks[idx].pcTaskName,
-                        (unsigned long)s_xEdfTasks[idx].currentPriority,
-                        (i < NUM_EDF_TASKS - 1) ? " > " : "");
-                }
-                printf("\n");
-
-                // Check if the highest priority task changed -> likely preemption
-                if (xNewHighestTaskHandle != s_highestPrioTaskHandle &&
-                    xNewHighestTaskHandle != NULL &&
-                    s_highestPrioTaskHandle != NULL) {
-
-                    // Find names for logging
-                    const char* newHighestName = "Unknown";
-                    const char* oldHighestName = "Unknown";
-
-                    for (int i = 0; i < NUM_EDF_TASKS; ++i) {
-                        if (s_xEdfTasks[i].xHandle == xNewHighestTaskHandle)
-                            newHighestName = s_xEdfTasks[i].pcTaskName;
-                        if (s_xEdfTasks[i].xHandle == s_highestPrioTaskHandle)
-                            oldHighestName = s_xEdfTasks[i].pcTaskName;
-                    }
-
-                    printf("  Context Switch: %s preempts %s (earlier deadline)\n\n",
-                        newHighestName, oldHighestName);
-                }
-
-                fflush(stdout);
-            }
+    for (;;) {
+#if EDF_SCHEDULER_MODE == EDF_MODE_POLLING
+        vTaskDelayUntil(&xLastCheckTime, xCheckFrequency);
+#else
+        // Sleep until a task releases or completes a job, the earliest
+        // deadline passes with its job unfinished, or the hyperperiod ends
+        TickType_t xNow = xTaskGetTickCount();
+        TickType_t xWait = (xNow <= s_simulationEnd) ? (s_simulationEnd - xNow + 1) : 0;
+        taskENTER_CRITICAL();
+        if (s_jobHeap.size > 0) {
+            TickType_t xLate = s_xEdfTasks[s_jobHeap.items[0]].xNextDeadline + 1;
+            if (xLate > xNow && xLate - xNow < xWait)
+                xWait = xLate - xNow;
+        }
+        taskEXIT_CRITICAL();
+        ulTaskNotifyTake(pdTRUE, xWait);
+#endif
+        TickType_t currentTick = xTaskGetTickCount();
+        s_schedulerWakeups++;
 
-            // Update the tracked highest priority task handle for the next cycle
-            s_highestPrioTaskHandle = xNewHighestTaskHandle;
+        // Check if simulation is complete
+        if (s_simulationComplete || currentTick > s_simulationEnd) {
+            // The logger prints the summary once everything before it is out
+            log_event(EDF_LOG_END, 0, 0, 0, 0, 0);
 
-            xSemaphoreGive(s_xEdfMutex);
-        }
-        else {
-            printf("[Scheduler] Tick=%-5lu ERROR: Failed to get mutex!\n", currentTick);
-            fflush(stdout);
+            s_simulationComplete = true;
+            taskENTER_CRITICAL();
+            TaskStatus_t xStatus;
+            vTaskGetInfo(NULL, &xStatus, pdFALSE, eInvalid);
+            s_schedulerCpuTime = xStatus.ulRunTimeCounter;
+            s_schedulerStackFree = uxTaskGetStackHighWaterMark(NULL);
+            s_xEdfSchedulerHandle = NULL;
+            taskEXIT_CRITICAL();
+            vTaskDelete(NULL);
+            return;
         }
+
+        uint32_t ulStart = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+        taskENTER_CRITICAL();
+        check_deadlines(currentTick);
+        rank_jobs();
+        taskEXIT_CRITICAL();
+        apply_priority_updates();
+        histogram_add(&s_schedulerCost, (uint32_t)portGET_RUN_TIME_COUNTER_VALUE() - ulStart);
     }
 }
+#endif
+
+// RAM taken by the EDF objects; all of it is static, so this is fixed at link time
+static void print_memory_report(uint32_t ulStackWords) {
+    printf("\n----- EDF MEMORY (static) -----\n");
+    for (int i = 0; i < s_numEdfTasks; i++) {
+        printf("- %-12s: stack %u words (%lu B) + TCB %lu B\n", s_xEdfTasks[i].pcTaskName,
+            (unsigned)s_xEdfTasks[i].usStackDepth,
+            (unsigned long)(s_xEdfTasks[i].usStackDepth * sizeof(StackType_t)),
+            (unsigned long)sizeof(StaticTask_t));
+    }
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+    printf("- %-12s: stack %d words (%lu B) + TCB %lu B\n", "EDFSched", EDF_SCHEDULER_STACK_SIZE,
+        (unsigned long)sizeof(s_schedulerStack), (unsigned long)sizeof(StaticTask_t));
+#endif
+    printf("- %-12s: stack %d words (%lu B) + TCB %lu B\n", "EDFLog", EDF_LOGGER_STACK_SIZE,
+        (unsigned long)sizeof(s_loggerStack), (unsigned long)sizeof(StaticTask_t));
+    printf("Stack pool: %lu of %lu words used\n",
+        (unsigned long)ulStackWords, (unsigned long)EDF_STACK_POOL_WORDS);
+
+    size_t tables = sizeof(s_xEdfTasks) + sizeof(s_jobHeap) + sizeof(s_releaseHeap) +
+        sizeof(s_priorityUpdates) + sizeof(s_logRing) + sizeof(s_switchRing) + sizeof(s_switchPairs) +
+        sizeof(s_sensorRings) + sizeof(s_sensorWindows);
+    size_t stacks = sizeof(s_stackPool) + sizeof(s_xTaskBuffers) + sizeof(s_loggerStack) + sizeof(StaticTask_t);
+#if EDF_SCHEDULER_MODE != EDF_MODE_TICK_HOOK
+    stacks += sizeof(s_schedulerStack) + sizeof(StaticTask_t);
+#endif
+    printf("Total: %lu B of stacks and TCBs, %lu B of EDF tables and rings\n",
+        (unsigned long)stacks, (unsigned long)tables);
+    printf("-------------------------------\n\n");
+}
 
-// --- Public Setup Function ---
-void start_edf_demo(void) {
-    printf("--- Initializing EDF Demo ---\n");
+// --- Public Setup Functions ---
+void set_edf_run_length(uint32_t ulHyperperiods) {
+    s_runHyperperiods = ulHyperperiods > 0 ? ulHyperperiods : 1;
+}
 
-    // Initialize sensors
-    initializeSensors();
+void set_edf_event_log(int enabled) {
+    s_printEvents = enabled != 0;
+}
 
-    // Create Mutex
-    s_xEdfMutex = xSemaphoreCreateMutex();
-    if (s_xEdfMutex == NULL) {
-        printf("ERROR: Failed to create EDF Mutex!\n");
-        fflush(stdout);
-        while (1);
-    }
+void set_edf_end_callback(void (*pxCallback)(void)) {
+    s_pxEndCallback = pxCallback;
+}
 
-    // Task Handles
-    TaskHandle_t tempHandle = NULL;
-    TaskHandle_t pressHandle = NULL;
-    TaskHandle_t heightHandle = NULL;
+int set_edf_trace_file(const char* pcPath) {
+    s_traceFile = fopen(pcPath, "w");
+    if (s_traceFile == NULL) {
+        printf("ERROR: cannot create trace file %s\n", pcPath);
+        return -1;
+    }
+    return 0;
+}
 
-    // Create Sensor Tasks
-    printf("Creating EDF Sensor Tasks...\n");
-    xTaskCreate(vTemperatureTask_EDF, "TempTask", EDF_SENSOR_TASK_STACK_SIZE,
-        (void*)0, EDF_SENSOR_TASK_INITIAL_PRIORITY, &tempHandle);
-    xTaskCreate(vPressureTask_EDF, "PressureTask", EDF_SENSOR_TASK_STACK_SIZE,
-        (void*)1, EDF_SENSOR_TASK_INITIAL_PRIORITY, &pressHandle);
-    xTaskCreate(vHeightTask_EDF, "HeightTask", EDF_SENSOR_TASK_STACK_SIZE,
-        (void*)2, EDF_SENSOR_TASK_INITIAL_PRIORITY, &heightHandle);
+int start_edf_demo_tasks(const EdfTaskDesc_t* pxTable, int count) {
+    if (count <= 0 || count > EDF_MAX_TASKS) {
+        printf("ERROR: EDF demo needs 1 to %d tasks, got %d\n", EDF_MAX_TASKS, count);
+        fflush(stdout);
+        return -1;
+    }
 
-    if (!tempHandle || !pressHandle || !heightHandle) {
-        printf("ERROR: Failed to create one or more EDF sensor tasks!\n");
+    uint32_t ulStackWords = 0;
+    for (int i = 0; i < count; i++) {
+        ulStackWords += pxTable[i].usStackDepth ? pxTable[i].usStackDepth : EDF_SENSOR_TASK_STACK_SIZE;
+    }
+    if (ulStackWords > EDF_STACK_POOL_WORDS) {
+        printf("ERROR: EDF task stacks need %lu words, EDF_STACK_POOL_WORDS is %lu\n",
+            (unsigned long)ulStackWords, (unsigned long)EDF_STACK_POOL_WORDS);
         fflush(stdout);
-        while (1);
+        return -1;
     }
 
-    // Initialize shared task info array
+    // Initialize shared task info array; the kernel is not running yet, so the
+    // shared state needs no locking here
     TickType_t now = xTaskGetTickCount();
     printf("Initializing EDF Task Info (Current Tick = %lu)...\n", (unsigned long)now);
 
-    if (xSemaphoreTake(s_xEdfMutex, portMAX_DELAY) == pdTRUE) {
-        s_xEdfTasks[0] = (EdfTaskInfo_t){
-            tempHandle,
-            pdMS_TO_TICKS(TEMP_TASK_PERIOD_MS),
-            now + pdMS_TO_TICKS(TEMP_TASK_PERIOD_MS),
-            "TempTask",
-            0,
+    heap_init(&s_jobHeap, deadline_before);
+    heap_init(&s_releaseHeap, release_before);
+    s_numEdfTasks = count;
+    for (int i = 0; i < count; i++) {
+        const EdfTaskDesc_t* desc = &pxTable[i];
+        TickType_t xPeriod = pdMS_TO_TICKS(desc->ulPeriodMs);
+        TickType_t xDeadline = desc->ulRelativeDeadlineMs ? pdMS_TO_TICKS(desc->ulRelativeDeadlineMs) : xPeriod;
+
+        s_xEdfTasks[i] = (EdfTaskInfo_t){
+            NULL,
+            xPeriod,
+            now + xPeriod + xDeadline, // First job is released one period in
+            desc->pcName,
+            i,
             EDF_SENSOR_TASK_INITIAL_PRIORITY,
-            1  // Initial job count
-        };
-
-        s_xEdfTasks[1] = (EdfTaskInfo_t){
-            pressHandle,
-            pdMS_TO_TICKS(PRESSURE_TASK_PERIOD_MS),
-            now + pdMS_TO_TICKS(PRESSURE_TASK_PERIOD_MS),
-            "PressureTask",
-            1,
+            1,  // Initial job count
+            xDeadline,
+            desc->pxJob,
             EDF_SENSOR_TASK_INITIAL_PRIORITY,
-            1  // Initial job count
-        };
-
-        s_xEdfTasks[2] = (EdfTaskInfo_t){
-            heightHandle,
-            pdMS_TO_TICKS(HEIGHT_TASK_PERIOD_MS),
-            now + pdMS_TO_TICKS(HEIGHT_TASK_PERIOD_MS),
-            "HeightTask",
-            2,
-            EDF_SENSOR_TASK_INITIAL_PRIORITY,
-            1  // Initial job count
+            false,
+            now + xPeriod,
+            desc->ucOverrunPolicy,
+            false, false, false,
+            0, 0, 0,
+            0,
+            { 0 },
+            0,
+            desc->usStackDepth ? desc->usStackDepth : EDF_SENSOR_TASK_STACK_SIZE,
+            0
         };
-
-        // Calculate hyperperiod
-        s_hyperperiod = calculate_hyperperiod();
-
-        xSemaphoreGive(s_xEdfMutex);
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+        heap_insert(&s_releaseHeap, i);
+#endif
+    }
+    s_rankedCount = 0;
+    s_updateHead = 0;
+    s_updateCount = 0;
+    s_highestPrioTaskIndex = -1;
+    s_simulationComplete = false;
+    s_schedulerCost = (EdfHistogram_t){ 0 };
+    s_schedulerCpuTime = 0;
+
+    // Calculate hyperperiod
+    s_hyperperiod = calculate_hyperperiod();
+    if (s_hyperperiod > (portMAX_DELAY / 2) / s_runHyperperiods) {
+        s_simulationEnd = portMAX_DELAY / 2;
+        printf("WARNING: %lu hyperperiods do not fit the tick counter, run capped at %lu ticks\n",
+            (unsigned long)s_runHyperperiods, (unsigned long)s_simulationEnd);
     }
     else {
-        printf("ERROR: Failed to get mutex for EDF init!\n");
-        fflush(stdout);
-        while (1);
+        s_simulationEnd = s_hyperperiod * s_runHyperperiods;
+    }
+
+    // Create the periodic tasks
+    // With every buffer supplied, xTaskCreateStatic() cannot fail
+    printf("Creating %d EDF Tasks (%d deadline bands)...\n", count, EDF_PRIORITY_LEVELS);
+    StackType_t* pxStack = s_stackPool;
+    for (int i = 0; i < count; i++) {
+        s_xEdfTasks[i].xHandle = xTaskCreateStatic(vPeriodicTask_EDF, pxTable[i].pcName,
+            s_xEdfTasks[i].usStackDepth, (void*)(intptr_t)i, EDF_SENSOR_TASK_INITIAL_PRIORITY,
+            pxStack, &s_xTaskBuffers[i]);
+        pxStack += s_xEdfTasks[i].usStackDepth;
+        vTaskSetApplicationTaskTag(s_xEdfTasks[i].xHandle, (TaskHookFunction_t)(uintptr_t)(i + 1));
     }
 
+#if EDF_SCHEDULER_MODE == EDF_MODE_TICK_HOOK
+    // No scheduler task: vEdfTickHook() does its work from the tick interrupt
+    print_banner();
+    printf("[Scheduler] EDF runs in the tick hook (no scheduler task)\n");
+    printf("\n----- EDF EXECUTION SEQUENCE -----\n");
+#else
     // Create EDF Scheduler Task
     printf("Creating EDF Scheduler Task...\n");
-    xTaskCreate(vEdfSchedulerTask_EDF, "EDFSched", EDF_SENSOR_TASK_STACK_SIZE,
-        NULL, EDF_SCHEDULER_PRIORITY, NULL);
+    s_xEdfSchedulerHandle = xTaskCreateStatic(vEdfSchedulerTask_EDF, "EDFSched", EDF_SCHEDULER_STACK_SIZE,
+        NULL, EDF_SCHEDULER_PRIORITY, s_schedulerStack, &s_xSchedulerBuffer);
+    vTaskSetApplicationTaskTag(s_xEdfSchedulerHandle, (TaskHookFunction_t)(uintptr_t)EDF_TRACE_SCHEDULER);
+#endif
+
+    s_logHead = s_logTail = 0;
+    s_logWritten = s_logDropped = s_logHighWater = 0;
+    TaskHandle_t xLoggerHandle = xTaskCreateStatic(vEdfLoggerTask, "EDFLog", EDF_LOGGER_STACK_SIZE, NULL,
+        EDF_LOGGER_PRIORITY, s_loggerStack, &s_xLoggerBuffer);
+    vTaskSetApplicationTaskTag(xLoggerHandle, (TaskHookFunction_t)(uintptr_t)EDF_TRACE_LOGGER);
+
+    // The kernel is not running yet, so the trace state needs no locking here
+    s_switchHead = s_switchTail = 0;
+    s_switchDropped = 0;
+    memset(s_switchPairs, 0, sizeof(s_switchPairs));
+    s_switchedOutTask = NULL;
+    s_lastEdfId = EDF_TRACE_OTHER;
+    s_edfSwitches = s_edfPreemptions = 0;
+    s_traceEnabled = true;
+    if (s_traceFile != NULL) {
+        s_traceStart = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+        s_traceEvents = 0;
+        trace_tracks();
+    }
+
+    print_memory_report(ulStackWords);
 
     printf("EDF Demo Setup Complete.\n");
     fflush(stdout);
+    return 0;
+}
+
+void start_edf_demo(void) {
+    printf("--- Initializing EDF Demo ---\n");
+
+    // Initialize sensors
+    initializeSensors();
+    printf("Sensor seed: %lu\n", (unsigned long)getSensorSeed());
+
+    // The aggregator is the last entry; its index names the window records
+    s_aggregatorTask = (int)(sizeof(s_xSensorTasks) / sizeof(s_xSensorTasks[0])) - 1;
+    start_edf_demo_tasks(s_xSensorTasks, (int)(sizeof(s_xSensorTasks) / sizeof(s_xSensorTasks[0])));
+}
+
+void start_edf_stress_demo(void) {
+    // Harmonic-ish periods keep the hyperperiod at 3000 ms for any task count
+    static const uint32_t periodsMs[] = { 250, 500, 750, 1000, 1500, 3000 };
+    static const EdfJobFunction_t jobs[] = { getTemperature, getPressure, getHeight };
+    static const uint8_t overrunPolicies[] = { EDF_OVERRUN_DEMOTE, EDF_OVERRUN_SKIP_NEXT, EDF_OVERRUN_ABORT };
+    static char names[EDF_STRESS_TASK_COUNT][configMAX_TASK_NAME_LEN];
+    static EdfTaskDesc_t table[EDF_STRESS_TASK_COUNT];
+
+    printf("--- Initializing EDF Stress Demo (%d tasks) ---\n", EDF_STRESS_TASK_COUNT);
+    initializeSensors();
+    printf("Sensor seed: %lu\n", (unsigned long)getSensorSeed());
+
+    for (int i = 0; i < EDF_STRESS_TASK_COUNT; i++) {
+        uint32_t period = periodsMs[i % (sizeof(periodsMs) / sizeof(periodsMs[0]))];
+        snprintf(names[i], sizeof(names[i]), "Task%02d", i);
+        table[i] = (EdfTaskDesc_t){
+            names[i],
+            period,
+            period - period / 5, // Constrained deadline at 80% of the period
+            jobs[i % 3],
+            configMINIMAL_STACK_SIZE,
+            overrunPolicies[i % 3]
+        };
+    }
+
+    start_edf_demo_tasks(table, EDF_STRESS_TASK_COUNT);
 }
-     
\ No newline at end of file
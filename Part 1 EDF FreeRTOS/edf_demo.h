@@ -2,7 +2,58 @@
 #ifndef EDF_DEMO_H
 #define EDF_DEMO_H
 
+#include <stdint.h>
+
+// One job of a periodic task; the returned value is logged at job end
+typedef int (*EdfJobFunction_t)(void);
+
+// What happens to a job that is still unfinished at its deadline
+#define EDF_OVERRUN_CONTINUE   0 // Keep its EDF priority and finish late (later jobs may miss too)
+#define EDF_OVERRUN_SKIP_NEXT  1 // Finish late, then drop the next release to catch up
+#define EDF_OVERRUN_ABORT      2 // Not run if it starts late; a running job is demoted and finishes (job boundaries only)
+#define EDF_OVERRUN_DEMOTE     3 // Finish late in the bottom band, behind jobs that can still make it
+
+// Descriptor for one periodic EDF task
+typedef struct {
+    const char* pcName;
+    uint32_t ulPeriodMs;
+    uint32_t ulRelativeDeadlineMs; // 0 means the deadline equals the period
+    EdfJobFunction_t pxJob;
+    uint16_t usStackDepth;         // 0 means EDF_SENSOR_TASK_STACK_SIZE
+    uint8_t ucOverrunPolicy;       // One of EDF_OVERRUN_*
+} EdfTaskDesc_t;
+
 // Function to setup and create EDF tasks and scheduler
 void start_edf_demo(void);
 
-#endif // EDF_DEMO_H
\ No newline at end of file
+// Same, with EDF_STRESS_TASK_COUNT synthetic tasks sharing the priority bands
+void start_edf_stress_demo(void);
+
+// Create one periodic task per table entry plus the scheduler; returns 0 on
+// success, -1 if the table is empty or larger than EDF_MAX_TASKS
+int start_edf_demo_tasks(const EdfTaskDesc_t* pxTable, int count);
+
+// Run options; call before starting a demo. The run lasts ulHyperperiods
+// hyperperiods (default 1).
+void set_edf_run_length(uint32_t ulHyperperiods);
+
+// 0 stops the per-event lines (START/END Job, priority updates); the summary
+// is always printed
+void set_edf_event_log(int enabled);
+
+// Called by the logger task once the end-of-run summary is out
+void set_edf_end_callback(void (*pxCallback)(void));
+
+// Also write the run as a Chrome Trace Event (Perfetto) JSON file; returns -1
+// if the file cannot be created
+int set_edf_trace_file(const char* pcPath);
+
+// Called from vApplicationTickHook(); does the EDF bookkeeping when
+// EDF_SCHEDULER_MODE is EDF_MODE_TICK_HOOK
+void vEdfTickHook(void);
+
+// Called by the kernel from traceTASK_SWITCHED_OUT/IN (see FreeRTOSConfig.h)
+void vEdfTraceSwitchedOut(void* pvTask, void* pvTaskTag, long lStillReady);
+void vEdfTraceSwitchedIn(void* pvTask, void* pvTaskTag, unsigned long ulPriority);
+
+#endif // EDF_DEMO_H
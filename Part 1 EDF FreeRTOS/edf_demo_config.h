@@ -8,20 +8,72 @@
 #define TEMP_TASK_PERIOD_MS     500
 #define PRESSURE_TASK_PERIOD_MS 1000
 #define HEIGHT_TASK_PERIOD_MS   750
+#define AGGREGATOR_TASK_PERIOD_MS 1000
 #define EDF_SENSOR_TASK_STACK_SIZE  ( configMINIMAL_STACK_SIZE + 50 )
 
+// Demo milliseconds per tick. Periods are converted with pdMS_TO_TICKS(); a
+// headless build may run the tick faster than real time (posix/FreeRTOSConfig.h)
+#ifndef EDF_MS_PER_TICK
+#define EDF_MS_PER_TICK         portTICK_PERIOD_MS
+#endif
+
 // --- EDF Configuration ---
-#define NUM_EDF_TASKS           3
+#define EDF_MAX_TASKS           64 // Capacity of the task table
+#define EDF_STRESS_TASK_COUNT   50 // Tasks created by start_edf_stress_demo()
+
+// --- Static Allocation ---
+// The periodic tasks' stacks are carved from one pool, in table order; a
+// table needing more is rejected by start_edf_demo_tasks()
+#define EDF_STACK_POOL_WORDS    ( EDF_MAX_TASKS * EDF_SENSOR_TASK_STACK_SIZE )
+#define EDF_SCHEDULER_STACK_SIZE EDF_SENSOR_TASK_STACK_SIZE
 
 // Priority Levels for EDF demo
-// Ensure configMAX_PRIORITIES >= (EDF_BASE_PRIORITY + NUM_EDF_TASKS + 1) = 5
+// With configMAX_PRIORITIES = 10: IDLE = 0, deadline bands = 1..7, release = 8, scheduler = 9.
+// The EDF_PRIORITY_LEVELS - 1 earliest deadlines each get their own level and
+// all later jobs share EDF_BASE_PRIORITY; a job there is promoted as soon as one
+// ahead of it completes, so EDF order holds however many tasks there are.
 #define EDF_BASE_PRIORITY       ( tskIDLE_PRIORITY + 1 ) // Lowest priority EDF will assign (1)
-#define EDF_SCHEDULER_PRIORITY  ( EDF_BASE_PRIORITY + NUM_EDF_TASKS ) // Highest priority (4)
+#define EDF_PRIORITY_LEVELS     ( configMAX_PRIORITIES - EDF_BASE_PRIORITY - 2 ) // Deadline bands (7)
+#define EDF_RELEASE_PRIORITY    ( EDF_BASE_PRIORITY + EDF_PRIORITY_LEVELS ) // Blocked tasks wait here so releases are seen at once (8)
+#define EDF_SCHEDULER_PRIORITY  ( EDF_RELEASE_PRIORITY + 1 ) // Highest priority (9)
 
-// How often the EDF scheduler checks deadlines (in ms)
+// How the EDF scheduler task is woken
+#define EDF_MODE_POLLING        0 // Every EDF_CHECK_PERIOD_MS
+#define EDF_MODE_NOTIFY         1 // Task notification at every job release and completion
+#define EDF_MODE_TICK_HOOK      2 // No scheduler task: releases and ranking in vApplicationTickHook
+#ifndef EDF_SCHEDULER_MODE
+#define EDF_SCHEDULER_MODE      EDF_MODE_NOTIFY
+#endif
+
+// How often the EDF scheduler checks deadlines in EDF_MODE_POLLING (in ms)
 #define EDF_CHECK_PERIOD_MS     50
 
+// Most jobs the tick hook releases in one tick, bounding its run time; any
+// others are released on the following ticks
+#define EDF_HOOK_MAX_RELEASES_PER_TICK 8
+
+// --- Deferred Logging ---
+#define EDF_LOG_RING_SIZE       1024 // Event records buffered for the logger task (power of two)
+#define EDF_LOG_DRAIN_PERIOD_MS 10   // How often the logger task empties the ring
+#define EDF_LOGGER_PRIORITY     ( tskIDLE_PRIORITY ) // Only runs when no EDF job is ready
+#define EDF_LOGGER_STACK_SIZE   ( configMINIMAL_STACK_SIZE * 2 )
+
+// --- Instrumentation ---
+// Response times and scheduler cost are timed with the run-time stats counter
+// (configRUN_TIME_COUNTER_HZ); histogram bin i counts values below 2^i counts
+#define EDF_HISTOGRAM_BINS      24
+
+// Context switches traced by the kernel hooks; the logger drains the ring and
+// prints each switch when EDF_TRACE_LOG_SWITCHES is 1
+#define EDF_TRACE_RING_SIZE     4096 // Switch records (power of two)
+#define EDF_TRACE_LOG_SWITCHES  0
+
+// --- Sensor Pipeline ---
+// Each sensor task publishes into its own ring, read in place by the aggregator
+#define EDF_SENSOR_RING_SIZE    64 // Samples per sensor (power of two)
+#define EDF_SENSOR_WINDOW_SLOTS 8  // Fused windows kept until the logger prints them (power of two)
+
 // Initial priority for sensor tasks when created
-#define EDF_SENSOR_TASK_INITIAL_PRIORITY ( EDF_BASE_PRIORITY )
+#define EDF_SENSOR_TASK_INITIAL_PRIORITY ( EDF_RELEASE_PRIORITY )
 
 #endif // EDF_CONFIG_H
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 // Include headers for the AVAILABLE demo setup functions
 #include "edf_demo.h"
+#include "edf_demo_config.h"
 #include "rm_rcs_demo.h" // Only EDF and RM-RCS File demo remain
 
 // --- Only common stuff needed by FreeRTOS hooks remains ---
@@ -49,21 +50,22 @@ int main(void)
     printf("----------------------------------------\n");
     printf("  1. Earliest Deadline First (EDF - Sensor Tasks)\n");
     printf("  2. Rate Monotonic RCS (RM-RCS - File Input) Removed from here, please see separate c implementation\n"); // Re-numbered
+    printf("  3. EDF Stress Test (%d table-driven tasks)\n", EDF_STRESS_TASK_COUNT);
     printf("----------------------------------------\n");
-    printf("Enter choice (1-2): "); // Updated prompt
+    printf("Enter choice (1-3): "); // Updated prompt
 
     // Basic input loop (Updated Range)
-    while (choice < 1 || choice > 2) { // Check for 1 or 2
+    while (choice < 1 || choice > 3) { // Check for 1 to 3
         char inputChar = _getch(); // Get character without waiting for Enter
-        if (inputChar >= '1' && inputChar <= '2') { // Check against '1' and '2'
+        if (inputChar >= '1' && inputChar <= '3') { // Check against '1' to '3'
             choice = inputChar - '0'; // Convert char '1' or '2' to int
             printf("%c\n", inputChar); // Echo valid choice
         }
         else if (inputChar == '\r' || inputChar == '\n') {
-            printf("\nPlease enter 1 or 2: ");
+            printf("\nPlease enter 1, 2 or 3: ");
         }
         else {
-            printf("\nInvalid input. Please enter 1 or 2: ");
+            printf("\nInvalid input. Please enter 1, 2 or 3: ");
         }
     }
 
@@ -80,6 +82,10 @@ int main(void)
         printf("Starting RM-RCS (File Input) Demo...\n");
         start_rcs_file_demo(); // Make sure tasks.txt exists!
         break;
+    case 3:
+        printf("Starting EDF Stress Demo...\n");
+        start_edf_stress_demo();
+        break;
     default:
         // Should not happen due to input loop
         printf("ERROR: Invalid selection somehow.\n");
@@ -135,7 +141,11 @@ static void  prvInitialiseHeap(void)
 void vApplicationMallocFailedHook(void) { /* Handle error */ vAssertCalled(__LINE__, __FILE__); }
 void vApplicationIdleHook(void) { /* Optional */ }
 void vApplicationStackOverflowHook(TaskHandle_t pxTask, char* pcTaskName) { (void)pxTask; (void)pcTaskName; /* Handle error */ vAssertCalled(__LINE__, __FILE__); }
-void vApplicationTickHook(void) { /* Optional */ }
+void vApplicationTickHook(void)
+{
+    // Does nothing unless EDF_SCHEDULER_MODE is EDF_MODE_TICK_HOOK
+    vEdfTickHook();
+}
 #if ( configUSE_TIMERS == 1 ) // Only define if timers are enabled
 
 
@@ -0,0 +1,91 @@
+/*
+ * FreeRTOS configuration for the headless EDF build on the POSIX port (see
+ * Makefile). It follows ../FreeRTOSConfig.h wherever the EDF demo depends on
+ * it; the Win32 configuration is left untouched.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+ /*-----------------------------------------------------------*/
+ /* Application specific definitions. */
+ /*-----------------------------------------------------------*/
+
+/* How many times faster than real time the tick runs. Every tick still counts
+as one millisecond of demo time, so a 3000 ms hyperperiod takes 3000 ticks. */
+#ifndef EDF_TIME_COMPRESSION
+#define EDF_TIME_COMPRESSION                    10
+#endif
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     1
+#define configUSE_DAEMON_TASK_STARTUP_HOOK      0
+#define configTICK_RATE_HZ                      ( 1000 * EDF_TIME_COMPRESSION )
+#define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 16384 ) /* Words; at least PTHREAD_STACK_MIN bytes */
+#define configMAX_TASK_NAME_LEN                 ( 12 )
+#define configUSE_TRACE_FACILITY                1 /* vTaskGetInfo() for per-task CPU time */
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_MUTEXES                       1
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configUSE_APPLICATION_TASK_TAG          1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configSUPPORT_DYNAMIC_ALLOCATION        0 /* Every task, queue and timer is static; no heap is linked */
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configUSE_TIME_SLICING                  0
+
+/* Demo milliseconds per tick (edf_demo_config.h) */
+#define EDF_MS_PER_TICK                         1
+#define pdMS_TO_TICKS( xTimeInMs )              ( ( TickType_t ) ( xTimeInMs ) )
+
+/* Software timer related configuration options. */
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                20
+#define configTIMER_TASK_STACK_DEPTH            ( configMINIMAL_STACK_SIZE * 2 )
+
+#define configMAX_PRIORITIES                    ( 10 )
+
+/* Run time stats gathering configuration options. */
+unsigned long ulGetRunTimeCounterValue(void);
+void vConfigureTimerForRunTimeStats(void);
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_HZ               ( 1000000UL ) /* Microseconds, see Run-time-stats-utils.c */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vConfigureTimerForRunTimeStats()
+#define portGET_RUN_TIME_COUNTER_VALUE() ulGetRunTimeCounterValue()
+
+/* Co-routine related configuration options. */
+#define configUSE_CO_ROUTINES                   0
+#define configMAX_CO_ROUTINE_PRIORITIES         ( 2 )
+
+/* Set the following definitions to 1 to include the API function, or zero to exclude. */
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_xTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTimerGetTimerDaemonTaskHandle  1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_xTimerPendFunctionCall          1
+
+/* Define configASSERT() for debugging. */
+extern void vAssertCalled(unsigned long ulLine, const char* const pcFileName);
+#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __LINE__, __FILE__ )
+
+/* Exact context-switch accounting for the EDF demo, as in ../FreeRTOSConfig.h */
+void vEdfTraceSwitchedOut(void* pvTask, void* pvTaskTag, long lStillReady);
+void vEdfTraceSwitchedIn(void* pvTask, void* pvTaskTag, unsigned long ulPriority);
+#define traceTASK_SWITCHED_OUT() vEdfTraceSwitchedOut( ( void * ) pxCurrentTCB, ( void * ) pxCurrentTCB->pxTaskTag, \
+    ( long ) listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) )
+#define traceTASK_SWITCHED_IN() vEdfTraceSwitchedIn( ( void * ) pxCurrentTCB, ( void * ) pxCurrentTCB->pxTaskTag, \
+    ( unsigned long ) pxCurrentTCB->uxPriority )
+
+#endif /* FREERTOS_CONFIG_H */
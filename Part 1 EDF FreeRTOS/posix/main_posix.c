@@ -0,0 +1,244 @@
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "edf_demo.h"
+#include "edf_demo_config.h"
+#include "sensors.h"
+
+// Headless entry point for the EDF demo on the FreeRTOS POSIX port: the demo
+// and task table come from the command line, and the process exits once the
+// run's summary is printed.
+
+void vApplicationTickHook(void);
+void vApplicationGetIdleTaskMemory(StaticTask_t** ppxIdleTaskTCBBuffer, StackType_t** ppxIdleTaskStackBuffer, uint32_t* pulIdleTaskStackSize);
+void vApplicationGetTimerTaskMemory(StaticTask_t** ppxTimerTaskTCBBuffer, StackType_t** ppxTimerTaskStackBuffer, uint32_t* pulTimerTaskStackSize);
+void vAssertCalled(unsigned long ulLine, const char* const pcFileName);
+
+// Task table read by --table
+static EdfTaskDesc_t s_xTable[EDF_MAX_TASKS];
+static char s_names[EDF_MAX_TASKS][configMAX_TASK_NAME_LEN];
+
+static void print_usage(const char* program)
+{
+    printf("Usage: %s [options]\n", program);
+    printf("  -d, --demo NAME         sensors (default), stress or table\n");
+    printf("  -t, --table FILE        Task table, one task per line:\n");
+    printf("                          name period_ms [deadline_ms [overrun]]\n");
+    printf("                          overrun is continue, skip, abort or demote\n");
+    printf("  -n, --hyperperiods N    Run N hyperperiods (default 1)\n");
+    printf("  -s, --seed N            Seed the sensors with N (default: the time)\n");
+    printf("  -q, --quiet             Print only the banner and the summary\n");
+    printf("  -o, --trace FILE        Write a Chrome/Perfetto JSON trace of the run\n");
+    printf("  -h, --help              Show this help\n");
+    printf("The tick runs %d times faster than real time (EDF_TIME_COMPRESSION).\n", EDF_TIME_COMPRESSION);
+}
+
+static int parse_overrun(const char* name, uint8_t* policy)
+{
+    if (strcmp(name, "continue") == 0) *policy = EDF_OVERRUN_CONTINUE;
+    else if (strcmp(name, "skip") == 0) *policy = EDF_OVERRUN_SKIP_NEXT;
+    else if (strcmp(name, "abort") == 0) *policy = EDF_OVERRUN_ABORT;
+    else if (strcmp(name, "demote") == 0) *policy = EDF_OVERRUN_DEMOTE;
+    else return -1;
+    return 0;
+}
+
+// Returns the number of tasks read, or -1 after printing the error
+static int load_task_table(const char* path)
+{
+    static const EdfJobFunction_t jobs[] = { getTemperature, getPressure, getHeight };
+    FILE* fp = fopen(path, "r");
+    char line[256];
+    int lineNumber = 0;
+    int count = 0;
+
+    if (!fp) {
+        printf("Error opening %s\n", path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        char name[64];
+        char overrun[16] = "continue";
+        unsigned long period = 0;
+        unsigned long deadline = 0;
+
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+
+        int fields = sscanf(line, "%63s %lu %lu %15s", name, &period, &deadline, overrun);
+        if (fields <= 0)
+            continue;
+        if (fields < 2 || period == 0 || deadline > period) {
+            printf("%s:%d: expected \"name period_ms [deadline_ms [overrun]]\" with deadline <= period\n",
+                path, lineNumber);
+            fclose(fp);
+            return -1;
+        }
+        if (count == EDF_MAX_TASKS) {
+            printf("%s:%d: more than %d tasks\n", path, lineNumber, EDF_MAX_TASKS);
+            fclose(fp);
+            return -1;
+        }
+
+        EdfTaskDesc_t* desc = &s_xTable[count];
+        snprintf(s_names[count], sizeof(s_names[count]), "%s", name);
+        desc->pcName = s_names[count];
+        desc->ulPeriodMs = (uint32_t)period;
+        desc->ulRelativeDeadlineMs = (uint32_t)deadline;
+        desc->pxJob = jobs[count % 3];
+        desc->usStackDepth = 0;
+        if (parse_overrun(overrun, &desc->ucOverrunPolicy) != 0) {
+            printf("%s:%d: unknown overrun policy %s\n", path, lineNumber, overrun);
+            fclose(fp);
+            return -1;
+        }
+        count++;
+    }
+
+    fclose(fp);
+    if (count == 0)
+        printf("%s: no tasks\n", path);
+    return count > 0 ? count : -1;
+}
+
+static void prvEndOfRun(void)
+{
+    fflush(stdout);
+    exit(0);
+}
+
+int main(int argc, char** argv)
+{
+    const char* demo = "sensors";
+    const char* tablePath = NULL;
+    unsigned long hyperperiods = 1;
+    int quiet = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (strcmp(arg, "-q") == 0 || strcmp(arg, "--quiet") == 0) {
+            quiet = 1;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printf("Option %s needs a value\n", arg);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (strcmp(arg, "-d") == 0 || strcmp(arg, "--demo") == 0) {
+            demo = value;
+        }
+        else if (strcmp(arg, "-t") == 0 || strcmp(arg, "--table") == 0) {
+            tablePath = value;
+            demo = "table";
+        }
+        else if (strcmp(arg, "-n") == 0 || strcmp(arg, "--hyperperiods") == 0) {
+            hyperperiods = strtoul(value, NULL, 10);
+            if (hyperperiods == 0) {
+                printf("Invalid number of hyperperiods %s\n", value);
+                return 1;
+            }
+        }
+        else if (strcmp(arg, "-o") == 0 || strcmp(arg, "--trace") == 0) {
+            if (set_edf_trace_file(value) != 0)
+                return 1;
+        }
+        else if (strcmp(arg, "-s") == 0 || strcmp(arg, "--seed") == 0) {
+            char* end;
+            unsigned long seed = strtoul(value, &end, 0);
+            if (*end != '\0') {
+                printf("Invalid seed %s\n", value);
+                return 1;
+            }
+            setSensorSeed((uint32_t)seed);
+        }
+        else {
+            printf("Unknown option %s\n", arg);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    set_edf_run_length((uint32_t)hyperperiods);
+    set_edf_event_log(!quiet);
+    set_edf_end_callback(prvEndOfRun);
+
+    if (strcmp(demo, "sensors") == 0) {
+        start_edf_demo();
+    }
+    else if (strcmp(demo, "stress") == 0) {
+        start_edf_stress_demo();
+    }
+    else if (strcmp(demo, "table") == 0) {
+        if (!tablePath) {
+            printf("The table demo needs --table FILE\n");
+            return 1;
+        }
+        int count = load_task_table(tablePath);
+        if (count < 0)
+            return 1;
+        initializeSensors();
+        printf("Sensor seed: %lu\n", (unsigned long)getSensorSeed());
+        if (start_edf_demo_tasks(s_xTable, count) != 0)
+            return 1;
+    }
+    else {
+        printf("Unknown demo %s\n", demo);
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    fflush(stdout);
+    vTaskStartScheduler();
+
+    // Only reached if the idle or timer task could not be created
+    printf("Scheduler returned. Halting.\n");
+    return 1;
+}
+
+/*-----------------------------------------------------------*/
+
+void vApplicationTickHook(void)
+{
+    // Does nothing unless EDF_SCHEDULER_MODE is EDF_MODE_TICK_HOOK
+    vEdfTickHook();
+}
+
+// The kernel's own tasks are static too, as in main.c
+void vApplicationGetIdleTaskMemory(StaticTask_t** ppxIdleTaskTCBBuffer, StackType_t** ppxIdleTaskStackBuffer, uint32_t* pulIdleTaskStackSize)
+{
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[configMINIMAL_STACK_SIZE];
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t** ppxTimerTaskTCBBuffer, StackType_t** ppxTimerTaskStackBuffer, uint32_t* pulTimerTaskStackSize)
+{
+    static StaticTask_t xTimerTaskTCB;
+    static StackType_t uxTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+void vAssertCalled(unsigned long ulLine, const char* const pcFileName)
+{
+    printf("ASSERT! Line %lu, file %s\n", ulLine, pcFileName);
+    fflush(stdout);
+    abort();
+}
@@ -1,23 +1,99 @@
 #include "sensors.h"
-#include <stdlib.h> 
+#include <stdbool.h>
 #include <time.h>   // Required for time()
 
-// Function to initialize the random number generator
+// Range of each sensor's readings, indexed by SensorType_t
+static const struct {
+    int min;
+    uint32_t span; // max - min + 1
+} s_ranges[SENSOR_COUNT] = {
+    { 10, 81 },  // Temperature
+    { 2, 9 },    // Pressure
+    { 100, 901 } // Height
+};
+
+// One generator per sensor, used only by that sensor's task
+static SensorRng_t s_rngs[SENSOR_COUNT];
+static uint32_t s_seed = 0;
+static bool s_seedFixed = false;
+
+static uint32_t rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// xoshiro128** (Blackman & Vigna)
+static uint32_t rng_next(SensorRng_t* rng) {
+    uint32_t* s = rng->s;
+    uint32_t result = rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+}
+
+// SplitMix32 expands the seed into a state; the stream number keeps the
+// sensors' sequences apart
+void seedSensorRng(SensorRng_t* rng, uint32_t seed, uint32_t stream) {
+    uint32_t x = seed ^ (stream * 0x9E3779B9u);
+    for (int i = 0; i < 4; i++) {
+        uint32_t z = (x += 0x9E3779B9u);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        rng->s[i] = z ^ (z >> 16);
+    }
+}
+
+// Multiply-shift maps 32 random bits onto the range without a division
+void sampleSensor(SensorRng_t* rng, SensorType_t sensor, int* out, int count) {
+    int min = s_ranges[sensor].min;
+    uint32_t span = s_ranges[sensor].span;
+    for (int i = 0; i < count; i++) {
+        out[i] = min + (int)(((uint64_t)rng_next(rng) * span) >> 32);
+    }
+}
+
+void getSensorSamples(SensorType_t sensor, int* out, int count) {
+    sampleSensor(&s_rngs[sensor], sensor, out, count);
+}
+
+void setSensorSeed(uint32_t seed) {
+    s_seed = seed;
+    s_seedFixed = true;
+}
+
+uint32_t getSensorSeed(void) {
+    return s_seed;
+}
+
+// Function to initialize the random number generators
 void initializeSensors(void) {
-    // we are seeding the random number generator once.
     // Passing NULL to time() to get the current calendar time.
-    srand((unsigned int)time(NULL));
+    if (!s_seedFixed)
+        s_seed = (uint32_t)time(NULL);
+    for (int i = 0; i < SENSOR_COUNT; i++)
+        seedSensorRng(&s_rngs[i], s_seed, (uint32_t)i);
 }
 
 // Function to get a random temperature between 10 and 90
 int getTemperature(void) {
-    return (rand() % 81) + 10;
+    int value;
+    getSensorSamples(SENSOR_TEMPERATURE, &value, 1);
+    return value;
 }
 
 int getPressure(void) {
-    return (rand() % 9) + 2;
+    int value;
+    getSensorSamples(SENSOR_PRESSURE, &value, 1);
+    return value;
 }
 
 int getHeight(void) {
-    return (rand() % 901) + 100;
-}
\ No newline at end of file
+    int value;
+    getSensorSamples(SENSOR_HEIGHT, &value, 1);
+    return value;
+}
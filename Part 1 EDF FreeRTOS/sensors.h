@@ -2,12 +2,40 @@
 #ifndef SENSORS_H
 #define SENSORS_H
 
-// Function prototypes for the APIs
+#include <stdint.h>
+
+// Simulated sensors
+typedef enum {
+    SENSOR_TEMPERATURE = 0, // 10..90
+    SENSOR_PRESSURE,        // 2..10
+    SENSOR_HEIGHT,          // 100..1000
+    SENSOR_COUNT
+} SensorType_t;
+
+// xoshiro128** generator state. Each generator belongs to one task, so
+// sampling needs no lock; a seeded generator always yields the same readings.
+typedef struct {
+    uint32_t s[4];
+} SensorRng_t;
+
+// Function prototypes for the APIs; each sensor has its own generator
 int getTemperature(void);
 int getPressure(void);
 int getHeight(void);
 
-// Function to initialize the random number generator (call once at startup)
+// Fill out[0..count-1] with consecutive readings from one sensor's generator
+void getSensorSamples(SensorType_t sensor, int* out, int count);
+
+// Same, from a caller-owned generator (e.g. one per task)
+void seedSensorRng(SensorRng_t* rng, uint32_t seed, uint32_t stream);
+void sampleSensor(SensorRng_t* rng, SensorType_t sensor, int* out, int count);
+
+// Fixes the seed used by initializeSensors(); without it the seed comes from
+// time(NULL). Same seed, same readings.
+void setSensorSeed(uint32_t seed);
+uint32_t getSensorSeed(void);
+
+// Function to seed every sensor's generator (call once at startup)
 void initializeSensors(void);
 
-#endif // for SENSORS_H 
\ No newline at end of file
+#endif // for SENSORS_H
@@ -0,0 +1,304 @@
+#include "admission.h"
+#include <stdlib.h>
+#include <string.h>
+
+// How much of a cached result survives a change. Response times only grow
+// when interference is added, so the old fixed point is a valid start for
+// the next iteration; a removal or a shorter job needs a fresh start.
+#define RESULT_VALID 0 // Up to date
+#define RESULT_BELOW 1 // Lower bound of the new value
+#define RESULT_STALE 2 // Recompute from scratch
+
+typedef struct {
+    int handle;
+    int wcet;
+    int period;
+    long long response; // Last fixed point, or the first value past the period
+    int state;          // RESULT_*
+    long long deferred; // RM-RCS: the same with one lower-priority job extended first
+    int deferred_state; // RESULT_*
+} AdmissionTask;
+
+struct AdmissionContext {
+    int policy;
+    AdmissionTask* tasks;  // Highest RM priority first: shorter period, then older handle
+    AdmissionTask* backup; // Tasks saved by admission_admit_task() for a rollback
+    int count;
+    int capacity;
+    int next_handle;
+    double utilization;
+    long long busy_period; // EDF: length of the synchronous busy period
+    int busy_state;        // RESULT_*
+};
+
+static int is_edf(const AdmissionContext* ctx) {
+    return ctx->policy == ADMISSION_POLICY_EDF || ctx->policy == ADMISSION_POLICY_EDF_RCS;
+}
+
+static int find_task(const AdmissionContext* ctx, int handle) {
+    for (int i = 0; i < ctx->count; i++) {
+        if (ctx->tasks[i].handle == handle) return i;
+    }
+    return -1;
+}
+
+// Index the task would take in priority order
+static int insert_position(const AdmissionContext* ctx, int period, int handle) {
+    int i = 0;
+    while (i < ctx->count && (ctx->tasks[i].period < period ||
+           (ctx->tasks[i].period == period && ctx->tasks[i].handle < handle))) {
+        i++;
+    }
+    return i;
+}
+
+static void mark_from(AdmissionContext* ctx, int from, int state) {
+    for (int i = from; i < ctx->count; i++) {
+        if (ctx->tasks[i].state < state) ctx->tasks[i].state = state;
+        if (ctx->tasks[i].deferred_state < state) ctx->tasks[i].deferred_state = state;
+    }
+    if (ctx->busy_state < state) ctx->busy_state = state;
+}
+
+// The RM-RCS bound of a task also depends on the tasks below it
+static void mark_deferred_above(AdmissionContext* ctx, int to, int state) {
+    if (ctx->policy != ADMISSION_POLICY_RMRCS) return;
+    for (int i = 0; i < to; i++) {
+        if (ctx->tasks[i].deferred_state < state) ctx->tasks[i].deferred_state = state;
+    }
+}
+
+// Sum of the divisions drifts over many removals, so those recompute it
+static void update_utilization(AdmissionContext* ctx) {
+    ctx->utilization = 0;
+    for (int i = 0; i < ctx->count; i++) {
+        ctx->utilization += (double)ctx->tasks[i].wcet / ctx->tasks[i].period;
+    }
+}
+
+static int reserve(AdmissionContext* ctx, int count) {
+    if (count <= ctx->capacity) return 0;
+    int capacity = ctx->capacity ? ctx->capacity * 2 : 16;
+    AdmissionTask* tasks = realloc(ctx->tasks, capacity * sizeof(AdmissionTask));
+    if (!tasks) return -1;
+    ctx->tasks = tasks;
+    AdmissionTask* backup = realloc(ctx->backup, capacity * sizeof(AdmissionTask));
+    if (!backup) return -1;
+    ctx->backup = backup;
+    ctx->capacity = capacity;
+    return 0;
+}
+
+// Response-time analysis: R = C + B + sum(ceil(R/Tj) * Cj) over the tasks
+// above i, iterated from start (or the cold start for RESULT_STALE). Stops at
+// the first value past the period, which is still a lower bound.
+static long long fixed_point(const AdmissionContext* ctx, int i, long long blocking,
+                             int state, long long start) {
+    const AdmissionTask* task = &ctx->tasks[i];
+    long long r = task->wcet + blocking;
+    if (state == RESULT_STALE) {
+        for (int j = 0; j < i; j++) r += ctx->tasks[j].wcet;
+    } else if (start > r) {
+        r = start;
+    }
+    while (r <= task->period) {
+        long long next = task->wcet + blocking;
+        for (int j = 0; j < i; j++) {
+            next += (r + ctx->tasks[j].period - 1) / ctx->tasks[j].period * ctx->tasks[j].wcet;
+        }
+        if (next == r) break;
+        r = next;
+    }
+    return r;
+}
+
+static long long task_response(AdmissionContext* ctx, int i) {
+    AdmissionTask* task = &ctx->tasks[i];
+    if (task->state != RESULT_VALID) {
+        task->response = fixed_point(ctx, i, 0, task->state, task->response);
+        task->state = RESULT_VALID;
+    }
+    return task->response;
+}
+
+// RM-RCS extends the running job only up to its own completion and never
+// starts a lower-priority job over a ready higher one, so a job waits behind
+// at most one lower-priority job: the blocking term is the longest lower WCET
+static long long deferred_response(AdmissionContext* ctx, int i) {
+    AdmissionTask* task = &ctx->tasks[i];
+    if (task->deferred_state != RESULT_VALID) {
+        long long blocking = 0;
+        for (int j = i + 1; j < ctx->count; j++) {
+            if (ctx->tasks[j].wcet > blocking) blocking = ctx->tasks[j].wcet;
+        }
+        task->deferred = fixed_point(ctx, i, blocking, task->deferred_state, task->deferred);
+        task->deferred_state = RESULT_VALID;
+    }
+    return task->deferred;
+}
+
+// EDF: no job waits longer than the synchronous busy period L = sum(ceil(L/Tj) * Cj).
+// EDF-RCS is work-conserving as well, so the same busy period bounds it.
+// Past the longest period the period itself is the tighter bound, so the
+// iteration stops there (at U = 1 it would run to the hyperperiod).
+static long long busy_period(AdmissionContext* ctx) {
+    if (ctx->busy_state == RESULT_VALID) return ctx->busy_period;
+
+    long long longest = 0;
+    long long l = 0;
+    for (int i = 0; i < ctx->count; i++) {
+        if (ctx->tasks[i].period > longest) longest = ctx->tasks[i].period;
+        l += ctx->tasks[i].wcet;
+    }
+    if (ctx->busy_state == RESULT_BELOW && ctx->busy_period > l) l = ctx->busy_period;
+    while (l <= longest) {
+        long long next = 0;
+        for (int i = 0; i < ctx->count; i++) {
+            next += (l + ctx->tasks[i].period - 1) / ctx->tasks[i].period * ctx->tasks[i].wcet;
+        }
+        if (next == l) break;
+        l = next;
+    }
+    ctx->busy_period = l;
+    ctx->busy_state = RESULT_VALID;
+    return l;
+}
+
+AdmissionContext* admission_create(int policy) {
+    if (policy < ADMISSION_POLICY_RM || policy > ADMISSION_POLICY_EDF_RCS) return NULL;
+    AdmissionContext* ctx = calloc(1, sizeof(AdmissionContext));
+    if (!ctx) return NULL;
+    ctx->policy = policy;
+    return ctx;
+}
+
+void admission_destroy(AdmissionContext* ctx) {
+    if (!ctx) return;
+    free(ctx->tasks);
+    free(ctx->backup);
+    free(ctx);
+}
+
+int admission_add_task(AdmissionContext* ctx, int wcet, int period) {
+    if (wcet < 1 || period < 1 || reserve(ctx, ctx->count + 1) != 0) return -1;
+
+    int handle = ctx->next_handle++;
+    int pos = insert_position(ctx, period, handle);
+    memmove(&ctx->tasks[pos + 1], &ctx->tasks[pos], (ctx->count - pos) * sizeof(AdmissionTask));
+    ctx->tasks[pos].handle = handle;
+    ctx->tasks[pos].wcet = wcet;
+    ctx->tasks[pos].period = period;
+    ctx->tasks[pos].response = 0;
+    ctx->tasks[pos].state = RESULT_STALE;
+    ctx->tasks[pos].deferred = 0;
+    ctx->tasks[pos].deferred_state = RESULT_STALE;
+    ctx->count++;
+    ctx->utilization += (double)wcet / period;
+
+    // Tasks below only gain interference, tasks above only blocking
+    mark_from(ctx, pos + 1, RESULT_BELOW);
+    mark_deferred_above(ctx, pos, RESULT_BELOW);
+    return handle;
+}
+
+int admission_admit_task(AdmissionContext* ctx, int wcet, int period) {
+    if (wcet < 1 || period < 1 || reserve(ctx, ctx->count + 1) != 0) return -1;
+
+    // Only the tasks from the insert position down change (all of them for
+    // the RM-RCS bound); save them so a rejection keeps their analysis
+    int pos = ctx->policy == ADMISSION_POLICY_RMRCS ? 0 : insert_position(ctx, period, ctx->next_handle);
+    int tail = ctx->count - pos;
+    memcpy(ctx->backup, &ctx->tasks[pos], tail * sizeof(AdmissionTask));
+    double utilization = ctx->utilization;
+    long long busy = ctx->busy_period;
+    int busy_state = ctx->busy_state;
+
+    int handle = admission_add_task(ctx, wcet, period);
+    if (admission_schedulable(ctx)) return handle;
+
+    memcpy(&ctx->tasks[pos], ctx->backup, tail * sizeof(AdmissionTask));
+    ctx->count--;
+    ctx->next_handle--;
+    ctx->utilization = utilization;
+    ctx->busy_period = busy;
+    ctx->busy_state = busy_state;
+    return -1;
+}
+
+int admission_remove_task(AdmissionContext* ctx, int handle) {
+    int pos = find_task(ctx, handle);
+    if (pos < 0) return -1;
+
+    ctx->count--;
+    memmove(&ctx->tasks[pos], &ctx->tasks[pos + 1], (ctx->count - pos) * sizeof(AdmissionTask));
+    update_utilization(ctx);
+    mark_from(ctx, pos, RESULT_STALE);
+    mark_deferred_above(ctx, pos, RESULT_STALE);
+    return 0;
+}
+
+int admission_modify_task(AdmissionContext* ctx, int handle, int wcet, int period) {
+    int pos = find_task(ctx, handle);
+    if (pos < 0 || wcet < 1 || period < 1) return -1;
+
+    AdmissionTask task = ctx->tasks[pos];
+    // More work or a shorter period only adds interference below
+    int grows = wcet >= task.wcet && period <= task.period;
+    int from = pos;
+
+    ctx->count--;
+    memmove(&ctx->tasks[pos], &ctx->tasks[pos + 1], (ctx->count - pos) * sizeof(AdmissionTask));
+    int next = insert_position(ctx, period, handle);
+    memmove(&ctx->tasks[next + 1], &ctx->tasks[next], (ctx->count - next) * sizeof(AdmissionTask));
+    ctx->count++;
+    if (next < from) from = next;
+
+    // Its own response only grows with its WCET; a new period changes the
+    // tasks above it
+    int state = grows && period == task.period ? RESULT_BELOW : RESULT_STALE;
+    if (task.state < state) task.state = state;
+    if (task.deferred_state < state) task.deferred_state = state;
+    int old_period = task.period;
+    task.wcet = wcet;
+    task.period = period;
+    ctx->tasks[next] = task;
+    update_utilization(ctx);
+    mark_from(ctx, from, grows ? RESULT_BELOW : RESULT_STALE);
+    // A task that moved changes which tasks lie below the ones it passed
+    if (period == old_period) mark_deferred_above(ctx, from, grows ? RESULT_BELOW : RESULT_STALE);
+    else mark_deferred_above(ctx, ctx->count, RESULT_STALE);
+    return 0;
+}
+
+int admission_task_count(const AdmissionContext* ctx) {
+    return ctx->count;
+}
+
+int admission_schedulable(AdmissionContext* ctx) {
+    if (ctx->utilization > 1.0 + 1e-9) return 0;
+    // Implicit deadlines: U <= 1 is exact for EDF
+    if (is_edf(ctx)) return 1;
+    for (int i = 0; i < ctx->count; i++) {
+        if (task_response(ctx, i) > ctx->tasks[i].period) return 0;
+    }
+    return 1;
+}
+
+long long admission_response_time(AdmissionContext* ctx, int handle) {
+    int i = find_task(ctx, handle);
+    if (i < 0) return -1;
+    long long period = ctx->tasks[i].period;
+
+    if (is_edf(ctx)) {
+        if (ctx->utilization > 1.0 + 1e-9) return -1;
+        long long l = busy_period(ctx);
+        return l < period ? l : period;
+    }
+
+    // RM-RCS extends only while every deadline still holds, so it meets the
+    // deadlines RM meets and its bound never exceeds the period
+    if (task_response(ctx, i) > period) return -1;
+    if (ctx->policy != ADMISSION_POLICY_RMRCS) return ctx->tasks[i].response;
+    long long r = deferred_response(ctx, i);
+    return r < period ? r : period;
+}
@@ -0,0 +1,46 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+// Embeddable admission control: the schedulability analysis behind the
+// simulators, without their globals or output files. Every call works on its
+// own context, so contexts can live in different threads; one context must
+// not be used by two threads at once. Deadlines equal periods, and offsets
+// are ignored (the synchronous release is the worst case).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADMISSION_POLICY_RM      0 // Response-time analysis in RM priority order
+#define ADMISSION_POLICY_RMRCS   1 // RM test; WCRT adds one extended lower-priority job
+#define ADMISSION_POLICY_EDF     2 // Utilization test; WCRT from the busy period
+#define ADMISSION_POLICY_EDF_RCS 3 // EDF test and bound (RCS is work-conserving)
+
+typedef struct AdmissionContext AdmissionContext;
+
+// Returns NULL for an unknown policy or when memory runs out
+AdmissionContext* admission_create(int policy);
+void admission_destroy(AdmissionContext* ctx);
+
+// Adds a task and returns its handle (>= 0), or -1 for a wcet or period
+// below 1 or when memory runs out. The set may become unschedulable.
+int admission_add_task(AdmissionContext* ctx, int wcet, int period);
+// Adds the task only if the set stays schedulable; returns its handle, or -1
+// if it was rejected (the context is left unchanged)
+int admission_admit_task(AdmissionContext* ctx, int wcet, int period);
+// Return 0 on success, -1 for an unknown handle or a bad wcet or period
+int admission_remove_task(AdmissionContext* ctx, int handle);
+int admission_modify_task(AdmissionContext* ctx, int handle, int wcet, int period);
+
+int admission_task_count(const AdmissionContext* ctx);
+// Returns 1 if every task meets its deadline under the policy, else 0
+int admission_schedulable(AdmissionContext* ctx);
+// Worst-case response time bound of one task, or -1 for an unknown handle or
+// a task that can miss its deadline
+long long admission_response_time(AdmissionContext* ctx, int handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADMISSION_H
@@ -1,6 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include "taskset_loader.h"
+#include "trace_export.h"
+#include "sim_stats.h"
 
 #define MAX_TASKS 10
 #define MAX_JOBS 100
@@ -86,6 +89,7 @@ int has_higher_priority(int t1, int t2) {
 
 // Checking if extending the current job by a specific amount is feasible
 int is_extension_feasible(int current_job_idx, float current_time, float extension_time) {
+    sim_stats.feasibility_calls++;
 
     Job sim_jobs[MAX_JOBS];
     for (int i = 0; i < job_count; i++) {
@@ -168,6 +172,7 @@ int is_extension_feasible(int current_job_idx, float current_time, float extensi
         
         time += exec_time;
         sim_jobs[next_job].remaining -= exec_time;
+        sim_stats.feasibility_jobs++;
         
         // Check deadline
         if (time > sim_jobs[next_job].deadline && sim_jobs[next_job].remaining > 0) {
@@ -213,6 +218,7 @@ float find_max_extension(int current_job_idx, float current_time) {
     float best_ext = 0;
     
     while (max_ext - min_ext > 0.001) {
+        sim_stats.extension_iterations++;
         float mid_ext = (min_ext + max_ext) / 2;
         if (is_extension_feasible(current_job_idx, current_time, mid_ext)) {
             best_ext = mid_ext;
@@ -230,6 +236,7 @@ void simulate_rmrcs() {
     int current_job_idx = -1;
     
     while (current_time < hyperperiod) {
+        sim_stats.events++;
        
         int next_job_idx = -1;
         for (int i = 0; i < job_count; i++) {
@@ -322,12 +329,15 @@ void simulate_rmrcs() {
             schedule[schedule_idx].end = current_time + exec_time;
             schedule[schedule_idx].context_switch = context_switch;
             schedule_idx++;
-            
-            jobs[current_job_idx].remaining -= exec_time;
-            current_time += exec_time;
         }
-        
+        // Still advance on a sliver, or an event under the tolerance away
+        // would stall the clock
+        jobs[current_job_idx].remaining -= exec_time;
+        current_time += exec_time;
+
         if (jobs[current_job_idx].remaining <= 0.001) {
+            // A residue below the tolerance would be picked again forever
+            jobs[current_job_idx].remaining = 0;
             current_job_idx = -1; // Job completed
         }
     }
@@ -355,8 +365,11 @@ void optimize_schedule() {
     schedule_idx = write_idx + 1;
 }
 
-void print_schedule(char* filename) {
+void print_schedule(const char* filename) {
+    double start = stats_now_ns();
     optimize_schedule();
+    stats_phase_end(STATS_PHASE_OPTIMIZE, start);
+    start = stats_now_ns();
     
     FILE* fp = fopen(filename, "w");
     if (!fp) {
@@ -387,49 +400,110 @@ void print_schedule(char* filename) {
     fprintf(fp, "Total Idle Time: %.1f\n", idle_time);
     
     fclose(fp);
+    stats_phase_end(STATS_PHASE_REPORT, start);
+}
+
+// Same layout as the WCET simulator's trace; idle entries are left as gaps
+#define TRACE_US_PER_UNIT 1000
+
+void export_trace(const char* filename, const char* tasks_path) {
+    TraceWriter tw;
+    char name[96];
+    snprintf(name, sizeof(name), "RM-RCS (actual times) schedule of %s", tasks_path);
+    if (trace_open(&tw, filename, name) != 0) return;
+
+    for (int t = 0; t < task_count; t++) {
+        snprintf(name, sizeof(name), "T%d (C=%d, actual %.1f, T=%d)", t + 1, tasks[t].wcet,
+                 tasks[t].actual, tasks[t].period);
+        trace_track(&tw, t + 1, name, t + 1);
+    }
+
+    int previous = 0;
+    for (int i = 0; i < schedule_idx; i++) {
+        const ScheduleEntry* e = &schedule[i];
+        if (e->task_id == 0) continue;
+        long long start = llroundf(e->start * TRACE_US_PER_UNIT);
+        long long end = llroundf(e->end * TRACE_US_PER_UNIT);
+        snprintf(name, sizeof(name), "T%dj%d", e->task_id, e->job_id);
+        trace_slice(&tw, e->task_id, name, start, end - start);
+        if (e->context_switch) {
+            trace_instant(&tw, e->task_id, "CS", start, "from_task", previous);
+        }
+        previous = e->task_id;
+    }
+
+    long long events = trace_close(&tw);
+    if (events < 0) {
+        printf("Error writing trace file %s\n", filename);
+    } else {
+        printf("Trace with %lld events written to %s\n", events, filename);
+    }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    double program_start = stats_now_ns();
+    CliOptions opts = { .tasks_path = "tasks.txt", .actual_path = "actual.txt",
+                        .output_path = "schedule3.txt", .format = TASKSET_FORMAT_AUTO };
+    int status = parse_cli_options(argc, argv, CLI_ACTUAL | CLI_TRACE | CLI_STATS, &opts);
+    if (status != 0) {
+        return status < 0 ? 1 : 0;
+    }
+    
     // Read tasks.txt
-    FILE* fp = fopen("tasks.txt", "r");
-    if (!fp) {
-        printf("Error opening tasks.txt\n");
+    double phase_start = stats_now_ns();
+    TaskSet set;
+    if (load_taskset(opts.tasks_path, opts.format, &set) != 0) {
         return 1;
     }
-    
-    while (fscanf(fp, "%d %d %d", &tasks[task_count].arrival, 
-                &tasks[task_count].wcet, &tasks[task_count].period) == 3) {
+    if (set.count == 0 || set.count > MAX_TASKS) {
+        printf("Simulator supports 1 to %d tasks\n", MAX_TASKS);
+        free_taskset(&set);
+        return 1;
+    }
+    for (int i = 0; i < set.count; i++) {
         tasks[task_count].id = task_count + 1;
+        tasks[task_count].arrival = set.tasks[i].arrival;
+        tasks[task_count].wcet = set.tasks[i].wcet;
+        tasks[task_count].period = set.tasks[i].period;
         tasks[task_count].actual = tasks[task_count].wcet; // Default to WCET
         task_count++;
     }
-    fclose(fp);
+    free_taskset(&set);
     
     // Read actual.txt
-    FILE* act_fp = fopen("actual.txt", "r");
-    if (act_fp) {
-        float actual;
-        int i = 0;
-        while (fscanf(act_fp, "%f", &actual) == 1 && i < task_count) {
-            tasks[i].actual = actual;
-            printf("Task %d actual execution time: %.1f (WCET: %d)\n", 
-                   i+1, tasks[i].actual, tasks[i].wcet);
-            i++;
-        }
-        fclose(act_fp);
+    float actual[MAX_TASKS];
+    int actual_count = load_actual_times(opts.actual_path, actual, task_count);
+    for (int i = 0; i < actual_count; i++) {
+        tasks[i].actual = actual[i];
+        printf("Task %d actual execution time: %.1f (WCET: %d)\n", 
+               i+1, tasks[i].actual, tasks[i].wcet);
     }
+    stats_phase_end(STATS_PHASE_LOAD, phase_start);
     
     calculate_hyperperiod();
     printf("Hyperperiod: %d\n", hyperperiod);
     
+    phase_start = stats_now_ns();
     generate_jobs();
+    stats_phase_end(STATS_PHASE_GENERATE, phase_start);
     printf("Generated %d jobs\n", job_count);
     
+    phase_start = stats_now_ns();
     simulate_rmrcs();
+    stats_phase_end(STATS_PHASE_SIMULATE, phase_start);
     printf("Simulation completed\n");
     
-    print_schedule("schedule3.txt");
-    printf("Schedule written to schedule3.txt\n");
+    print_schedule(opts.output_path);
+    printf("Schedule written to %s\n", opts.output_path);
+    if (opts.trace_path) {
+        phase_start = stats_now_ns();
+        export_trace(opts.trace_path, opts.tasks_path);
+        stats_phase_end(STATS_PHASE_REPORT, phase_start);
+    }
+    if (opts.stats_path) {
+        write_stats_json(opts.stats_path, "main_actual_time", "RM-RCS", task_count, hyperperiod,
+                         stats_now_ns() - program_start);
+    }
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,493 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#include "admission.h"
+#include "sim_stats.h"
+
+// Long-running schedulability service. Each query line names a policy and a
+// task set; the answer comes from an LRU cache keyed on the canonical form of
+// the set, or from the admission-control analysis on a miss.
+
+#define MAX_QUERY_TASKS 1024
+#define MAX_LINE 65536
+#define MAX_CLIENTS 32
+#define DEFAULT_CACHE_SIZE 4096
+#define LATENCY_WINDOW 65536 // Percentiles cover the latest queries
+
+typedef struct {
+    int wcet;
+    int period;
+    int index; // Position in the query, for the answer
+} QueryTask;
+
+// Canonical set: tasks sorted by period then WCET, all times divided by
+// their GCD. Scaling time scales every response time by the same factor.
+typedef struct CacheEntry {
+    unsigned long long hash;
+    int* key;          // Policy, task count, then (wcet, period) per task
+    int key_len;
+    int schedulable;
+    long long* wcrt;   // In canonical order and units, -1 for a possible miss
+    struct CacheEntry* prev; // LRU list, most recent first
+    struct CacheEntry* next;
+    struct CacheEntry* chain; // Hash bucket
+} CacheEntry;
+
+typedef struct {
+    int fd;
+    char buf[MAX_LINE];
+    size_t len;
+    int overflow; // Dropping the rest of a line longer than the buffer
+} Client;
+
+CacheEntry** buckets;
+int bucket_count;
+CacheEntry* lru_head;
+CacheEntry* lru_tail;
+int cache_size;
+int cache_capacity = DEFAULT_CACHE_SIZE;
+
+long long queries = 0;
+long long hits = 0;
+double latency_us[LATENCY_WINDOW];
+long long latency_count = 0;
+
+volatile sig_atomic_t stop_requested = 0;
+
+void handle_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+int policy_from_name(const char* name) {
+    if (strcmp(name, "rm") == 0) return ADMISSION_POLICY_RM;
+    if (strcmp(name, "rmrcs") == 0) return ADMISSION_POLICY_RMRCS;
+    if (strcmp(name, "edf") == 0) return ADMISSION_POLICY_EDF;
+    if (strcmp(name, "edfrcs") == 0) return ADMISSION_POLICY_EDF_RCS;
+    return -1;
+}
+
+int gcd(int a, int b) {
+    while (b) {
+        int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+int compare_query_tasks(const void* a, const void* b) {
+    const QueryTask* x = a;
+    const QueryTask* y = b;
+    if (x->period != y->period) return x->period < y->period ? -1 : 1;
+    if (x->wcet != y->wcet) return x->wcet < y->wcet ? -1 : 1;
+    return x->index - y->index;
+}
+
+int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+// FNV-1a over the key words, as in the simulator's state hash
+unsigned long long hash_key(const int* key, int len) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (int i = 0; i < len; i++) {
+        unsigned int v = (unsigned int)key[i];
+        for (int b = 0; b < 4; b++) {
+            h ^= (v >> (8 * b)) & 0xFF;
+            h *= 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+int init_cache() {
+    bucket_count = 1;
+    while (bucket_count < 2 * cache_capacity) bucket_count *= 2;
+    buckets = calloc(bucket_count, sizeof(CacheEntry*));
+    return buckets ? 0 : -1;
+}
+
+void lru_unlink(CacheEntry* e) {
+    if (e->prev) e->prev->next = e->next;
+    else lru_head = e->next;
+    if (e->next) e->next->prev = e->prev;
+    else lru_tail = e->prev;
+}
+
+void lru_push_front(CacheEntry* e) {
+    e->prev = NULL;
+    e->next = lru_head;
+    if (lru_head) lru_head->prev = e;
+    lru_head = e;
+    if (!lru_tail) lru_tail = e;
+}
+
+CacheEntry* cache_find(const int* key, int len, unsigned long long hash) {
+    for (CacheEntry* e = buckets[hash & (bucket_count - 1)]; e; e = e->chain) {
+        if (e->hash == hash && e->key_len == len && memcmp(e->key, key, len * sizeof(int)) == 0) {
+            lru_unlink(e);
+            lru_push_front(e);
+            return e;
+        }
+    }
+    return NULL;
+}
+
+void cache_remove(CacheEntry* e) {
+    CacheEntry** link = &buckets[e->hash & (bucket_count - 1)];
+    while (*link != e) link = &(*link)->chain;
+    *link = e->chain;
+    lru_unlink(e);
+    free(e);
+    cache_size--;
+}
+
+// Key and results share the entry's allocation; returns NULL without memory
+CacheEntry* cache_insert(const int* key, int len, unsigned long long hash, int count) {
+    if (cache_size >= cache_capacity) cache_remove(lru_tail);
+    CacheEntry* e = malloc(sizeof(CacheEntry) + count * sizeof(long long) + len * sizeof(int));
+    if (!e) return NULL;
+    e->wcrt = (long long*)(e + 1);
+    e->key = (int*)(e->wcrt + count);
+    memcpy(e->key, key, len * sizeof(int));
+    e->key_len = len;
+    e->hash = hash;
+    CacheEntry** bucket = &buckets[hash & (bucket_count - 1)];
+    e->chain = *bucket;
+    *bucket = e;
+    lru_push_front(e);
+    cache_size++;
+    return e;
+}
+
+// Analysis of the canonical set on a cache miss
+int analyse(CacheEntry* e, int policy, const int* pairs, int count) {
+    AdmissionContext* ctx = admission_create(policy);
+    if (!ctx) return -1;
+    int handles[MAX_QUERY_TASKS];
+    for (int i = 0; i < count; i++) {
+        handles[i] = admission_add_task(ctx, pairs[2 * i], pairs[2 * i + 1]);
+        if (handles[i] < 0) {
+            admission_destroy(ctx);
+            return -1;
+        }
+    }
+    e->schedulable = admission_schedulable(ctx);
+    for (int i = 0; i < count; i++) {
+        e->wcrt[i] = admission_response_time(ctx, handles[i]);
+    }
+    admission_destroy(ctx);
+    return 0;
+}
+
+void record_latency(double us) {
+    latency_us[latency_count % LATENCY_WINDOW] = us;
+    latency_count++;
+}
+
+int format_stats(char* out, size_t size) {
+    int n = latency_count < LATENCY_WINDOW ? (int)latency_count : LATENCY_WINDOW;
+    static double sorted[LATENCY_WINDOW];
+    memcpy(sorted, latency_us, n * sizeof(double));
+    qsort(sorted, n, sizeof(double), compare_doubles);
+    double p50 = n ? sorted[(n - 1) * 50 / 100] : 0;
+    double p90 = n ? sorted[(n - 1) * 90 / 100] : 0;
+    double p99 = n ? sorted[(n - 1) * 99 / 100] : 0;
+    double max = n ? sorted[n - 1] : 0;
+    return snprintf(out, size,
+                    "queries %lld hits %lld misses %lld hit_rate %.1f%% cached %d "
+                    "p50 %.2fus p90 %.2fus p99 %.2fus max %.2fus\n",
+                    queries, hits, queries - hits, queries ? 100.0 * hits / queries : 0.0,
+                    cache_size, p50, p90, p99, max);
+}
+
+// Splits off the next blank-separated word; NULL at the end of the line
+char* next_word(char** cursor) {
+    char* p = *cursor;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    if (*p == '\0') return NULL;
+    char* word = p;
+    while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+    if (*p) *p++ = '\0';
+    *cursor = p;
+    return word;
+}
+
+// One query: "POLICY wcet/period ..." answered with "schedulable|unschedulable"
+// and each task's WCRT bound in query order (-1 if it can miss), then
+// whether the cache answered. Returns the reply length, -1 to close.
+int handle_line(char* line, char* out, size_t size) {
+    char* cursor = line;
+    char* word = next_word(&cursor);
+    if (!word || word[0] == '#') return 0;
+    if (strcmp(word, "quit") == 0) return -1;
+    if (strcmp(word, "stats") == 0) return format_stats(out, size);
+
+    double start = stats_now_ns();
+    int policy = policy_from_name(word);
+    if (policy < 0) return snprintf(out, size, "error unknown policy %s\n", word);
+
+    QueryTask tasks[MAX_QUERY_TASKS];
+    int count = 0;
+    while ((word = next_word(&cursor)) != NULL) {
+        char* end;
+        long wcet = strtol(word, &end, 10);
+        if (*end != '/') return snprintf(out, size, "error expected wcet/period, got %s\n", word);
+        long period = strtol(end + 1, &end, 10);
+        if (*end != '\0' || wcet < 1 || period < 1 || wcet > 1000000000 || period > 1000000000) {
+            return snprintf(out, size, "error bad task %s\n", word);
+        }
+        if (count == MAX_QUERY_TASKS) {
+            return snprintf(out, size, "error more than %d tasks\n", MAX_QUERY_TASKS);
+        }
+        tasks[count].wcet = (int)wcet;
+        tasks[count].period = (int)period;
+        tasks[count].index = count;
+        count++;
+    }
+    if (count == 0) return snprintf(out, size, "error empty task set\n");
+
+    qsort(tasks, count, sizeof(QueryTask), compare_query_tasks);
+    int g = 0;
+    for (int i = 0; i < count; i++) {
+        g = gcd(g, tasks[i].wcet);
+        g = gcd(g, tasks[i].period);
+    }
+    int key[2 + 2 * MAX_QUERY_TASKS];
+    int len = 2 + 2 * count;
+    key[0] = policy;
+    key[1] = count;
+    for (int i = 0; i < count; i++) {
+        key[2 + 2 * i] = tasks[i].wcet / g;
+        key[3 + 2 * i] = tasks[i].period / g;
+    }
+
+    unsigned long long hash = hash_key(key, len);
+    CacheEntry* e = cache_find(key, len, hash);
+    int hit = e != NULL;
+    if (!e) {
+        e = cache_insert(key, len, hash, count);
+        if (!e || analyse(e, policy, key + 2, count) != 0) {
+            if (e) cache_remove(e);
+            return snprintf(out, size, "error out of memory\n");
+        }
+    }
+
+    long long wcrt[MAX_QUERY_TASKS];
+    for (int i = 0; i < count; i++) {
+        wcrt[tasks[i].index] = e->wcrt[i] < 0 ? -1 : e->wcrt[i] * g;
+    }
+    queries++;
+    hits += hit;
+
+    int n = snprintf(out, size, "%s", e->schedulable ? "schedulable" : "unschedulable");
+    for (int i = 0; i < count && n < (int)size; i++) {
+        n += snprintf(out + n, size - n, " %lld", wcrt[i]);
+    }
+    if (n < (int)size) n += snprintf(out + n, size - n, " %s\n", hit ? "hit" : "miss");
+    record_latency((stats_now_ns() - start) / 1e3);
+    return n < (int)size ? n : (int)size - 1;
+}
+
+void print_daemon_usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  -s, --socket PATH     Serve clients on a Unix domain socket instead of stdin\n");
+    printf("      --cache N         Canonical task sets kept in the LRU cache (default %d)\n",
+           DEFAULT_CACHE_SIZE);
+    printf("  -h, --help            Show this help\n");
+    printf("Queries, one per line:\n");
+    printf("  POLICY W/T ...        rm, rmrcs, edf or edfrcs and each task's wcet/period\n");
+    printf("  stats                 Cache hit rate and query latency percentiles\n");
+    printf("  quit                  Close the connection (end of input with stdin)\n");
+}
+
+int serve_stdin() {
+    static char line[MAX_LINE];
+    static char reply[MAX_LINE];
+    while (!stop_requested && fgets(line, sizeof(line), stdin)) {
+        size_t len = strlen(line);
+        if (len == sizeof(line) - 1 && line[len - 1] != '\n') {
+            int c;
+            while ((c = getchar()) != EOF && c != '\n') {}
+            printf("error line longer than %d bytes\n", MAX_LINE - 1);
+            fflush(stdout);
+            continue;
+        }
+        int n = handle_line(line, reply, sizeof(reply));
+        if (n < 0) break;
+        if (n > 0) {
+            fputs(reply, stdout);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+#ifndef _WIN32
+int write_all(int fd, const char* data, int len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        data += n;
+        len -= (int)n;
+    }
+    return 0;
+}
+
+// Answers every complete line in the client's buffer; returns -1 to close
+int serve_client(Client* c) {
+    static char reply[MAX_LINE];
+    ssize_t got = read(c->fd, c->buf + c->len, sizeof(c->buf) - 1 - c->len);
+    if (got < 0 && errno == EINTR) return 0;
+    if (got <= 0) return -1;
+    c->len += (size_t)got;
+
+    size_t start = 0;
+    for (size_t i = 0; i < c->len; i++) {
+        if (c->buf[i] != '\n') continue;
+        c->buf[i] = '\0';
+        int n = 0;
+        if (!c->overflow) n = handle_line(c->buf + start, reply, sizeof(reply));
+        c->overflow = 0;
+        start = i + 1;
+        if (n < 0 || (n > 0 && write_all(c->fd, reply, n) != 0)) return -1;
+    }
+    memmove(c->buf, c->buf + start, c->len - start);
+    c->len -= start;
+    if (c->len == sizeof(c->buf) - 1) {
+        int n = snprintf(reply, sizeof(reply), "error line longer than %d bytes\n", MAX_LINE - 1);
+        if (write_all(c->fd, reply, n) != 0) return -1;
+        c->len = 0;
+        c->overflow = 1;
+    }
+    return 0;
+}
+
+// One poll() loop over the listening socket and its clients
+int serve_socket(const char* path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Socket path %s is too long\n", path);
+        return -1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        printf("Error creating socket: %s\n", strerror(errno));
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, MAX_CLIENTS) != 0) {
+        printf("Error listening on %s: %s\n", path, strerror(errno));
+        close(listener);
+        return -1;
+    }
+    printf("Listening on %s\n", path);
+    fflush(stdout);
+
+    static Client clients[MAX_CLIENTS];
+    int client_count = 0;
+    struct pollfd fds[MAX_CLIENTS + 1];
+    while (!stop_requested) {
+        fds[0].fd = listener;
+        fds[0].events = client_count < MAX_CLIENTS ? POLLIN : 0;
+        for (int i = 0; i < client_count; i++) {
+            fds[i + 1].fd = clients[i].fd;
+            fds[i + 1].events = POLLIN;
+        }
+        if (poll(fds, client_count + 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            printf("Error in poll: %s\n", strerror(errno));
+            break;
+        }
+        // Walk the clients backwards so closing one does not skip the next
+        for (int i = client_count - 1; i >= 0; i--) {
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            if (serve_client(&clients[i]) != 0) {
+                close(clients[i].fd);
+                clients[i] = clients[--client_count];
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, NULL, NULL);
+            if (fd >= 0) {
+                clients[client_count].fd = fd;
+                clients[client_count].len = 0;
+                clients[client_count].overflow = 0;
+                client_count++;
+            }
+        }
+    }
+
+    for (int i = 0; i < client_count; i++) close(clients[i].fd);
+    close(listener);
+    unlink(path);
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv) {
+    const char* socket_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            print_daemon_usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc || (strcmp(arg, "-s") != 0 && strcmp(arg, "--socket") != 0 &&
+                              strcmp(arg, "--cache") != 0)) {
+            printf(i + 1 >= argc ? "Option %s needs a value\n" : "Unknown option %s\n", arg);
+            print_daemon_usage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (strcmp(arg, "--cache") == 0) {
+            cache_capacity = atoi(value);
+            if (cache_capacity < 1 || cache_capacity > (1 << 24)) {
+                printf("Cache size must be between 1 and %d\n", 1 << 24);
+                return 1;
+            }
+        } else {
+            socket_path = value;
+        }
+    }
+    if (init_cache() != 0) {
+        printf("Out of memory for a cache of %d entries\n", cache_capacity);
+        return 1;
+    }
+
+    signal(SIGINT, handle_stop);
+    signal(SIGTERM, handle_stop);
+    int status;
+    if (socket_path) {
+#ifndef _WIN32
+        signal(SIGPIPE, SIG_IGN);
+        status = serve_socket(socket_path);
+#else
+        printf("--socket is not available on Windows; queries are read from stdin\n");
+        status = -1;
+#endif
+    } else {
+        status = serve_stdin();
+    }
+
+    // The summary goes to stderr so stdin mode keeps one reply per query on stdout
+    char summary[256];
+    format_stats(summary, sizeof(summary));
+    fprintf(stderr, "%s", summary);
+    return status == 0 ? 0 : 1;
+}
@@ -1,16 +1,59 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+#include "taskset_loader.h"
+#include "trace_export.h"
+#include "sim_stats.h"
 
 #define MAX_TASKS 10
-#define MAX_JOBS 100
+#define MAX_JOBS 200
+#define MAX_APERIODIC 100
+#define MAX_SPORADIC_RELEASES 50
+#define MAX_RESOURCES 8
+#define MAX_SECTIONS 32
+#define MAX_REGIONS 64
 #define QUANTUM 1 
 
+// Task kinds: periodic tasks come from tasks.txt, sporadic ones from
+// sporadic.txt, and the aperiodic server (if any) from server.txt
+#define TASK_PERIODIC 0
+#define TASK_SPORADIC 1
+#define TASK_SERVER   2
+
+#define SERVER_NONE       0
+#define SERVER_POLLING    1
+#define SERVER_DEFERRABLE 2
+#define SERVER_SPORADIC   3
+
+// Resource access protocols for the critical sections in resources.txt
+#define PROTOCOL_NONE 0
+#define PROTOCOL_PCP  1 // Priority ceiling protocol (blocks on lock, with inheritance)
+#define PROTOCOL_SRP  2 // Stack resource policy (blocks before the job starts)
+
+// Scheduling policies; the first four use RM priorities, the EDF ones rank
+// jobs by absolute deadline, and they differ in when a higher-priority
+// arrival is allowed to preempt the running job
+#define POLICY_RM     0 // Always preempt
+#define POLICY_RMRCS  1 // Defer while the online feasibility check passes
+#define POLICY_PT     2 // Defer unless the arrival beats the preemption threshold
+#define POLICY_LP     3 // Defer inside non-preemptive regions (fixed preemption points)
+#define POLICY_EDF    4 // Earliest deadline first, always preempt
+#define POLICY_EDFRCS 5 // EDF, deferring like RM-RCS
+#define POLICY_COUNT  6
+
 typedef struct {
     int id;
     int arrival;
     int wcet;
-    int period;
+    int period;     // Minimum inter-arrival time for sporadic tasks
+    int kind;
 } Task;
 
 typedef struct {
@@ -18,9 +61,27 @@ typedef struct {
     int job_id;
     int release;
     int deadline;
-    int remaining;
+    int remaining;  // Remaining budget for server jobs
+    int activation; // Sporadic server: end of last consumption, -1 if unused
+    int blocked;    // Time spent blocked by the resource access protocol
+    int finish;     // Completion time, -1 while unfinished
 } Job;
 
+typedef struct {
+    int arrival;
+    int exec;
+    int remaining;
+    int finish;
+} AperiodicJob;
+
+// A task holds resource while its executed time is in (offset, offset+length)
+typedef struct {
+    int task_id;
+    int resource;
+    int offset;
+    int length;
+} CriticalSection;
+
 typedef struct {
     int start;
     int end;
@@ -29,6 +90,23 @@ typedef struct {
     int context_switch;
 } ScheduleEntry;
 
+// The job cannot be preempted while its executed time is in (start, end)
+typedef struct {
+    int task_id;
+    int start;
+    int end;
+} NonPreemptiveRegion;
+
+typedef struct {
+    int context_switches;
+    int decisions;
+    double ns_per_decision;
+    int deadline_misses;
+    int analysis_schedulable;
+    double avg_response;
+    int max_response;
+} PolicyResult;
+
 
 Task tasks[MAX_TASKS];
 Job jobs[MAX_JOBS];
@@ -40,6 +118,37 @@ int task_count = 0;
 int job_count = 0;
 int hyperperiod = 0;
 
+// The simulation runs hyperperiod by hyperperiod from the largest offset and
+// stops once the state at a boundary repeats, at the latest at max offset + 2H
+int max_offset = 0;
+int horizon = 0;          // Max offset + 2H
+int sim_end = 0;          // Jobs are generated up to here
+int steady_state_at = -1; // Boundary the schedule repeats from, -1 if it never did
+int horizon_cut = 0;      // MAX_JOBS stopped the simulation before the horizon
+int schedule_full = 0;    // The schedule table filled up before the horizon
+
+AperiodicJob aperiodic[MAX_APERIODIC];
+int aperiodic_count = 0;
+int sporadic_releases[MAX_TASKS][MAX_SPORADIC_RELEASES];
+int sporadic_release_count[MAX_TASKS];
+int server_type = SERVER_NONE;
+
+CriticalSection sections[MAX_SECTIONS];
+int section_count = 0;
+int resource_protocol = PROTOCOL_NONE;
+int resource_ceiling[MAX_RESOURCES + 1]; // Shortest period among the users
+
+int policy = POLICY_RMRCS;
+int decisions = 0;
+int task_priority[MAX_TASKS]; // RM priority level, task_count-1 is the highest
+int pt_threshold[MAX_TASKS];  // Preemption threshold, a priority level >= task_priority
+int pt_schedulable = 0;
+int custom_priorities = 0; // task_priority holds a loaded or searched ordering, not RM
+
+NonPreemptiveRegion regions[MAX_REGIONS];
+int region_count = 0;
+int regions_declared[MAX_TASKS]; // 0 when the points were placed automatically
+
 
 int gcd(int a, int b) { return b == 0 ? a : gcd(b, a % b); }
 int lcm(int a, int b) { return a * b / gcd(a, b); }
@@ -53,96 +162,419 @@ void calculate_hyperperiod() {
 }
 
 
-void generate_jobs() {
-    job_count = 0;
+// Adds the jobs released in [from, to); leaves the jobs as they were and
+// returns 0 if they do not fit in MAX_JOBS
+int generate_jobs(int from, int to) {
+    int first_new = job_count;
     for (int i = 0; i < task_count; i++) {
-        int num_jobs = (hyperperiod - tasks[i].arrival + tasks[i].period - 1) / tasks[i].period;
-        for (int j = 0; j < num_jobs; j++) {
-            if (tasks[i].arrival + j * tasks[i].period >= hyperperiod) continue;
+        if (tasks[i].kind == TASK_SPORADIC) {
+            // Sporadic jobs are released at the recorded arrival instants
+            for (int j = 0; j < sporadic_release_count[i]; j++) {
+                int release = sporadic_releases[i][j];
+                if (release < from || release >= to) continue;
+                if (job_count >= MAX_JOBS) {
+                    job_count = first_new;
+                    return 0;
+                }
+
+                jobs[job_count] = (Job){ i + 1, j + 1, release, release + tasks[i].period, tasks[i].wcet, -1, 0, -1 };
+                job_count++;
+            }
+            continue;
+        }
+
+        if (tasks[i].kind == TASK_SERVER && server_type == SERVER_SPORADIC) {
+            // Sporadic server: one initial budget, replenished as it is consumed
+            if (from == 0) {
+                jobs[job_count] = (Job){ i + 1, 1, tasks[i].arrival, horizon, tasks[i].wcet, -1, 0, -1 };
+                job_count++;
+            }
+            continue;
+        }
+
+        int j = 0;
+        if (from > tasks[i].arrival) {
+            j = (from - tasks[i].arrival + tasks[i].period - 1) / tasks[i].period;
+        }
+        for (; tasks[i].arrival + j * tasks[i].period < to; j++) {
+            if (job_count >= MAX_JOBS) {
+                job_count = first_new;
+                return 0;
+            }
             
             jobs[job_count].task_id = i + 1;
             jobs[job_count].job_id = j + 1;
             jobs[job_count].release = tasks[i].arrival + j * tasks[i].period;
             jobs[job_count].deadline = jobs[job_count].release + tasks[i].period;
             jobs[job_count].remaining = tasks[i].wcet;
+            jobs[job_count].activation = -1;
+            jobs[job_count].blocked = 0;
+            jobs[job_count].finish = -1;
             job_count++;
         }
     }
+    sim_end = to;
+    return 1;
 }
 
 
 int has_higher_priority(int t1, int t2) {
+    if (custom_priorities) return task_priority[t1-1] > task_priority[t2-1];
     return tasks[t1-1].period < tasks[t2-1].period;
 }
 
+int is_server_job(const Job* job) {
+    return tasks[job->task_id-1].kind == TASK_SERVER;
+}
+
+int is_edf_policy(int p) {
+    return p == POLICY_EDF || p == POLICY_EDFRCS;
+}
+
+// Smaller runs first: the period under RM (or the rank in a custom
+// ordering), the absolute deadline under EDF. A server budget's deadline
+// field is its expiry, so EDF ranks every job by release + period, which is
+// the deadline of every other job.
+int priority_key(const Job* js, int idx) {
+    const Task* task = &tasks[js[idx].task_id-1];
+    if (is_edf_policy(policy)) return js[idx].release + task->period;
+    return custom_priorities ? task_count - 1 - task_priority[js[idx].task_id-1] : task->period;
+}
+
+// Job-level version of has_higher_priority for the current policy
+int job_has_higher_priority(const Job* js, int a, int b) {
+    if (is_edf_policy(policy)) return priority_key(js, a) < priority_key(js, b);
+    return has_higher_priority(js[a].task_id, js[b].task_id);
+}
+
+// First aperiodic request (FIFO) that has arrived and is not finished yet
+int pending_aperiodic(const AperiodicJob* ap, int time) {
+    for (int i = 0; i < aperiodic_count; i++) {
+        if (ap[i].arrival <= time && ap[i].remaining > 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int job_is_ready(const Job* js, int idx, const AperiodicJob* ap, int time) {
+    if (js[idx].release > time || js[idx].remaining <= 0) return 0;
+    if (!is_server_job(&js[idx])) return 1;
+
+    // Polling and deferrable budgets are lost at the end of the server period
+    if (server_type != SERVER_SPORADIC && time >= js[idx].deadline) return 0;
+
+    // A polling server runs at its priority even with an empty queue (and
+    // gives its budget up), the bandwidth-preserving servers wait for work
+    if (server_type == SERVER_POLLING) return 1;
+    return pending_aperiodic(ap, time) != -1;
+}
+
+int job_executed(const Job* job) {
+    return tasks[job->task_id-1].wcet - job->remaining;
+}
+
+int holds_section(const Job* job, const CriticalSection* cs) {
+    int executed = job_executed(job);
+    return cs->task_id == job->task_id && executed > cs->offset && executed < cs->offset + cs->length;
+}
+
+// Highest ceiling (as a period) among resources locked by jobs other than exclude
+int system_ceiling(const Job* js, int count, int exclude, int* holder) {
+    int ceiling = INT_MAX;
+    for (int i = 0; i < count; i++) {
+        if (i == exclude || js[i].remaining <= 0) continue;
+        for (int s = 0; s < section_count; s++) {
+            if (holds_section(&js[i], &sections[s]) && resource_ceiling[sections[s].resource] < ceiling) {
+                ceiling = resource_ceiling[sections[s].resource];
+                if (holder) *holder = i;
+            }
+        }
+    }
+    return ceiling;
+}
+
+// PCP blocks a job that tries to lock below the system ceiling, SRP blocks it
+// from starting at all
+int protocol_blocked(const Job* js, int count, int idx) {
+    if (resource_protocol == PROTOCOL_NONE || is_server_job(&js[idx])) return 0;
+
+    int executed = job_executed(&js[idx]);
+    int at_lock = 0;
+    if (resource_protocol == PROTOCOL_SRP) {
+        at_lock = (executed == 0);
+    } else {
+        for (int s = 0; s < section_count; s++) {
+            if (sections[s].task_id == js[idx].task_id && sections[s].offset == executed) {
+                at_lock = 1;
+            }
+        }
+    }
+    if (!at_lock) return 0;
+
+    return tasks[js[idx].task_id-1].period >= system_ceiling(js, count, idx, NULL);
+}
+
+// Priority key including what a PCP lock holder inherits
+int effective_key(const Job* js, int count, int idx, const AperiodicJob* ap, int time) {
+    int key = priority_key(js, idx);
+    if (resource_protocol != PROTOCOL_PCP) return key;
+
+    for (int i = 0; i < count; i++) {
+        if (i == idx || !job_is_ready(js, i, ap, time) || !protocol_blocked(js, count, i)) continue;
+        int holder = -1;
+        system_ceiling(js, count, i, &holder);
+        if (holder == idx && priority_key(js, i) < key) {
+            key = priority_key(js, i);
+        }
+    }
+    return key;
+}
+
+// Highest-priority ready job, applying the polling server rule on dispatch
+int pick_next_job(Job* js, int count, const AperiodicJob* ap, int time) {
+    for (;;) {
+        int next = -1;
+        int next_key = INT_MAX;
+        for (int i = 0; i < count; i++) {
+            if (job_is_ready(js, i, ap, time) && !protocol_blocked(js, count, i)) {
+                int key = effective_key(js, count, i, ap, time);
+                // Equal deadlines are served in release order, so a tie never preempts
+                if (next == -1 || key < next_key ||
+                    (key == next_key && is_edf_policy(policy) && js[i].release < js[next].release)) {
+                    next = i;
+                    next_key = key;
+                }
+            }
+        }
+
+        if (next != -1 && is_server_job(&js[next]) && pending_aperiodic(ap, time) == -1) {
+            js[next].remaining = 0; // Polling server found an empty queue
+            continue;
+        }
+        return next;
+    }
+}
+
+// Earliest release (or aperiodic arrival / server budget expiry) after time
+int next_event_time(const Job* js, int count, const AperiodicJob* ap, int time, int pending_only) {
+    int next = sim_end;
+    for (int i = 0; i < count; i++) {
+        if (js[i].release > time && js[i].release < next &&
+            (!pending_only || js[i].remaining > 0)) {
+            next = js[i].release;
+        }
+        if (server_type != SERVER_SPORADIC && is_server_job(&js[i]) && js[i].remaining > 0 &&
+            js[i].deadline > time && js[i].deadline < next) {
+            next = js[i].deadline;
+        }
+    }
+    for (int i = 0; i < aperiodic_count; i++) {
+        if (ap[i].arrival > time && ap[i].arrival < next && ap[i].remaining > 0) {
+            next = ap[i].arrival;
+        }
+    }
+    return next;
+}
+
+// Longest run the job can make before it has to be re-evaluated
+int dispatch_limit(const Job* js, int idx, const AperiodicJob* ap, int time) {
+    int limit = js[idx].remaining;
+    if (!is_server_job(&js[idx])) {
+        // Stop at every lock and unlock so the protocol is re-evaluated
+        int executed = job_executed(&js[idx]);
+        for (int s = 0; s < section_count; s++) {
+            if (sections[s].task_id != js[idx].task_id) continue;
+            int lock = sections[s].offset - executed;
+            int unlock = sections[s].offset + sections[s].length - executed;
+            if (lock > 0 && lock < limit) limit = lock;
+            if (unlock > 0 && unlock < limit) limit = unlock;
+        }
+        // Limited preemption re-evaluates at every preemption point
+        if (policy == POLICY_LP) {
+            for (int r = 0; r < region_count; r++) {
+                int until_point = regions[r].end - executed;
+                if (regions[r].task_id == js[idx].task_id && until_point > 0 && until_point < limit) {
+                    limit = until_point;
+                }
+            }
+        }
+        return limit;
+    }
+
+    // Only a polling server is ready with an empty queue; it has nothing to run
+    int a = pending_aperiodic(ap, time);
+    if (a == -1) return 0;
+    if (ap[a].remaining < limit) limit = ap[a].remaining;
+    if (server_type != SERVER_SPORADIC && js[idx].deadline - time < limit) {
+        limit = js[idx].deadline - time;
+    }
+    return limit;
+}
+
+// Run a job for amount time units; server jobs serve the aperiodic queue
+void consume(Job* js, int* count, int idx, AperiodicJob* ap, int time, int amount) {
+    js[idx].remaining -= amount;
+    if (!is_server_job(&js[idx])) {
+        if (js[idx].remaining == 0) js[idx].finish = time + amount;
+        return;
+    }
+
+    int a = pending_aperiodic(ap, time);
+    if (a == -1) return; // dispatch_limit() gave an empty queue no time
+    ap[a].remaining -= amount;
+    if (ap[a].remaining == 0) {
+        ap[a].finish = time + amount;
+    }
+
+    if (server_type == SERVER_POLLING && pending_aperiodic(ap, time + amount) == -1) {
+        js[idx].remaining = 0;
+    }
+
+    if (server_type == SERVER_SPORADIC) {
+        // Consumed budget comes back one server period after the activation;
+        // back-to-back consumption belongs to the same activation
+        Job* last = &js[idx];
+        for (int i = *count - 1; i > idx; i--) {
+            if (is_server_job(&js[i])) {
+                last = &js[i];
+                break;
+            }
+        }
+        if (last->activation == time && last->release > time) {
+            last->remaining += amount;
+            last->activation = time + amount;
+        } else if (*count < MAX_JOBS) {
+            int period = tasks[js[idx].task_id-1].period;
+            if (time + period < horizon) {
+                js[*count] = (Job){ js[idx].task_id, last->job_id + 1, time + period, horizon, amount, time + amount, 0, -1 };
+                (*count)++;
+            }
+        }
+    }
+}
+
+void update_resource_ceilings() {
+    for (int r = 0; r <= MAX_RESOURCES; r++) {
+        resource_ceiling[r] = INT_MAX;
+    }
+    for (int s = 0; s < section_count; s++) {
+        if (tasks[sections[s].task_id-1].period < resource_ceiling[sections[s].resource]) {
+            resource_ceiling[sections[s].resource] = tasks[sections[s].task_id-1].period;
+        }
+    }
+}
+
+// Longest critical section of a lower-priority task on a resource whose
+// ceiling is at least the task's priority (PCP and SRP block at most once)
+int blocking_bound(int t) {
+    int bound = 0;
+    for (int s = 0; s < section_count; s++) {
+        if (tasks[sections[s].task_id-1].period > tasks[t].period &&
+            resource_ceiling[sections[s].resource] <= tasks[t].period &&
+            sections[s].length > bound) {
+            bound = sections[s].length;
+        }
+    }
+    return bound;
+}
+
+// Charge the run to every higher-priority job the protocol is holding back
+void account_blocking(Job* js, int count, int running, const AperiodicJob* ap, int time, int amount) {
+    if (resource_protocol == PROTOCOL_NONE) return;
+    for (int i = 0; i < count; i++) {
+        if (i != running && job_is_ready(js, i, ap, time) && protocol_blocked(js, count, i) &&
+            job_has_higher_priority(js, i, running)) {
+            js[i].blocked += amount;
+        }
+    }
+}
+
+// Label used in the schedule: server entries carry the aperiodic request served
+int entry_job_id(const Job* js, int idx, const AperiodicJob* ap, int time) {
+    if (is_server_job(&js[idx])) {
+        return pending_aperiodic(ap, time) + 1;
+    }
+    return js[idx].job_id;
+}
+
 // Checking if extending the current job keeps all jobs schedulable
 int is_extension_feasible(int current_job_idx, int current_time, int quantum) {
+    sim_stats.feasibility_calls++;
   
     Job sim_jobs[MAX_JOBS];
+    AperiodicJob sim_aperiodic[MAX_APERIODIC];
+    int sim_job_count = job_count;
     for (int i = 0; i < job_count; i++) {
         sim_jobs[i] = jobs[i];
     }
+    for (int i = 0; i < aperiodic_count; i++) {
+        sim_aperiodic[i] = aperiodic[i];
+    }
     
     
     int extension = quantum;
-    if (extension > sim_jobs[current_job_idx].remaining) {
-        extension = sim_jobs[current_job_idx].remaining;
+    int limit = dispatch_limit(sim_jobs, current_job_idx, sim_aperiodic, current_time);
+    if (extension > limit) {
+        extension = limit;
+    }
+    // With critical sections the extension must also pass the RM-RCS test
+    // t + E + B <= D over the ready higher-priority jobs
+    if (section_count > 0) {
+        int E = 0;
+        int D = INT_MAX;
+        int B = 0;
+        for (int i = 0; i < job_count; i++) {
+            if (i == current_job_idx || !job_is_ready(jobs, i, aperiodic, current_time) ||
+                !job_has_higher_priority(jobs, i, current_job_idx)) continue;
+            E += jobs[i].remaining;
+            if (!is_server_job(&jobs[i]) && jobs[i].deadline < D) {
+                D = jobs[i].deadline;
+            }
+            if (blocking_bound(jobs[i].task_id - 1) > B) {
+                B = blocking_bound(jobs[i].task_id - 1);
+            }
+        }
+        if (E > 0 && current_time + extension + E + B > D) {
+            return 0;
+        }
     }
-    sim_jobs[current_job_idx].remaining -= extension;
     
-    // Simulateing RM scheduling from current_time + extension to hyperperiod
+    consume(sim_jobs, &sim_job_count, current_job_idx, sim_aperiodic, current_time, extension);
+    
+    // Simulating the policy's scheduling from current_time + extension to the
+    // end of the generated jobs
     int time = current_time + extension;
     
-    while (time < hyperperiod) {
+    while (time < sim_end) {
       
-        int next_job = -1;
-        for (int i = 0; i < job_count; i++) {
-            if (sim_jobs[i].release <= time && sim_jobs[i].remaining > 0) {
-                if (next_job == -1 || has_higher_priority(sim_jobs[i].task_id, sim_jobs[next_job].task_id)) {
-                    next_job = i;
-                }
-            }
-        }
+        int next_job = pick_next_job(sim_jobs, sim_job_count, sim_aperiodic, time);
         
         if (next_job == -1) {
             
-            int next_release = hyperperiod;
-            for (int i = 0; i < job_count; i++) {
-                if (sim_jobs[i].release > time && sim_jobs[i].release < next_release && 
-                    sim_jobs[i].remaining > 0) {
-                    next_release = sim_jobs[i].release;
-                }
-            }
+            int next_release = next_event_time(sim_jobs, sim_job_count, sim_aperiodic, time, 1);
             
-            if (next_release == hyperperiod) break;
+            if (next_release == sim_end) break;
             time = next_release;
             continue;
         }
         
         // Find next release time
-        int next_release = hyperperiod;
-        for (int i = 0; i < job_count; i++) {
-            if (sim_jobs[i].release > time && sim_jobs[i].release < next_release) {
-                next_release = sim_jobs[i].release;
-            }
-        }
+        int next_release = next_event_time(sim_jobs, sim_job_count, sim_aperiodic, time, 0);
         
         // Execute job until next release or completion
-        int execute_time;
-        if (next_release == hyperperiod) {
-            execute_time = sim_jobs[next_job].remaining;
-        } else {
+        int execute_time = dispatch_limit(sim_jobs, next_job, sim_aperiodic, time);
+        if (next_release != sim_end && next_release - time < execute_time) {
             execute_time = next_release - time;
-            if (execute_time > sim_jobs[next_job].remaining) {
-                execute_time = sim_jobs[next_job].remaining;
-            }
         }
         
+        consume(sim_jobs, &sim_job_count, next_job, sim_aperiodic, time, execute_time);
         time += execute_time;
-        sim_jobs[next_job].remaining -= execute_time;
+        sim_stats.feasibility_jobs++;
         
-        // Check deadline
-        if (sim_jobs[next_job].remaining == 0 && time > sim_jobs[next_job].deadline) {
+        // Check deadline (server budgets have no hard deadline)
+        if (!is_server_job(&sim_jobs[next_job]) &&
+            sim_jobs[next_job].remaining == 0 && time > sim_jobs[next_job].deadline) {
             return 0; // Deadline missed
         }
     }
@@ -151,30 +583,135 @@ int is_extension_feasible(int current_job_idx, int current_time, int quantum) {
 }
 
 
-void simulate_rmrcs() {
+int in_non_preemptive_region(const Job* job) {
+    int executed = job_executed(job);
+    for (int r = 0; r < region_count; r++) {
+        if (regions[r].task_id == job->task_id && executed > regions[r].start && executed < regions[r].end) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Whether the running job may keep the processor although next_job_idx has
+// a higher priority
+int defer_preemption(int current_job_idx, int next_job_idx, int current_time) {
+    switch (policy) {
+    case POLICY_RM:
+    case POLICY_EDF:
+        return 0;
+    case POLICY_PT:
+        return task_priority[jobs[next_job_idx].task_id-1] <= pt_threshold[jobs[current_job_idx].task_id-1];
+    case POLICY_LP:
+        return in_non_preemptive_region(&jobs[current_job_idx]);
+    default:
+        return is_extension_feasible(current_job_idx, current_time, QUANTUM);
+    }
+}
+
+unsigned long long hash_int(unsigned long long h, int value) {
+    for (int i = 0; i < 4; i++) {
+        h ^= (value >> (8 * i)) & 0xff;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Words of a boundary state: the offset, five per job, one per sporadic
+// release and two per aperiodic request
+#define STATE_MAX_WORDS (1 + 5 * MAX_JOBS + MAX_TASKS * MAX_SPORADIC_RELEASES + 2 * MAX_APERIODIC)
+
+// Everything the rest of the schedule depends on at boundary b, with times
+// relative to b: how far past b the check runs (a job may cross the
+// boundary), the unfinished jobs released before it (and which one is
+// running), pending sporadic server replenishments, and the sporadic
+// releases and aperiodic requests not served yet. Returns the word count.
+int boundary_state(int running, int b, int now, int* words) {
+    int n = 0;
+    words[n++] = now - b;
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].remaining <= 0) continue;
+        int replenishment = is_server_job(&jobs[i]) && server_type == SERVER_SPORADIC;
+        if (!replenishment && (jobs[i].release >= b || (is_server_job(&jobs[i]) && jobs[i].deadline <= b))) continue;
+        words[n++] = jobs[i].task_id;
+        if (replenishment) {
+            words[n++] = jobs[i].release > b ? jobs[i].release - b : 0; // Available budget has no age
+        } else {
+            words[n++] = jobs[i].release - b;
+            words[n++] = jobs[i].deadline - b;
+        }
+        words[n++] = jobs[i].remaining;
+        words[n++] = i == running;
+    }
+    for (int t = 0; t < task_count; t++) {
+        for (int j = 0; tasks[t].kind == TASK_SPORADIC && j < sporadic_release_count[t]; j++) {
+            if (sporadic_releases[t][j] >= b) words[n++] = sporadic_releases[t][j] - b;
+        }
+    }
+    for (int i = 0; i < aperiodic_count; i++) {
+        if (aperiodic[i].remaining > 0) {
+            words[n++] = aperiodic[i].arrival - b;
+            words[n++] = aperiodic[i].remaining;
+        }
+    }
+    return n;
+}
+
+// FNV-1a of a boundary state; equal hashes are confirmed word by word
+unsigned long long state_hash(const int* words, int n) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (int i = 0; i < n; i++) {
+        h = hash_int(h, words[i]);
+    }
+    return h;
+}
+
+void simulate_schedule() {
     int current_time = 0;
     int current_job_idx = -1;
+    int boundary = max_offset;
+    static int state_words[2][STATE_MAX_WORDS]; // This boundary and the previous one
+    int current_words = 0;
+    int previous_words = 0;
+    unsigned long long previous_state = 0;
     
-    while (current_time < hyperperiod) {
-        
-        int next_job_idx = -1;
-        for (int i = 0; i < job_count; i++) {
-            if (jobs[i].release <= current_time && jobs[i].remaining > 0) {
-                if (next_job_idx == -1 || has_higher_priority(jobs[i].task_id, jobs[next_job_idx].task_id)) {
-                    next_job_idx = i;
-                }
+    for (;;) {
+        // Every periodic release pattern is in phase from the largest offset
+        // on, so a state seen one hyperperiod earlier repeats from here
+        if (current_time >= boundary) {
+            int* words = state_words[current_words];
+            int n = boundary_state(current_job_idx, boundary, current_time, words);
+            unsigned long long state = state_hash(words, n);
+            if (boundary > max_offset && state == previous_state && n == previous_words &&
+                memcmp(words, state_words[!current_words], n * sizeof(int)) == 0) {
+                steady_state_at = boundary - hyperperiod;
+                break;
             }
+            previous_state = state;
+            previous_words = n;
+            current_words = !current_words;
+            if (boundary >= horizon) break;
+            if (boundary + hyperperiod > sim_end && !generate_jobs(sim_end, boundary + hyperperiod)) {
+                horizon_cut = 1;
+                break;
+            }
+            boundary += hyperperiod;
+            continue;
         }
+        // Each decision adds at most one entry
+        if (schedule_idx >= MAX_JOBS * 2) {
+            schedule_full = 1;
+            sim_end = current_time;
+            break;
+        }
+        decisions++;
+        sim_stats.events++;
+        
+        int next_job_idx = pick_next_job(jobs, job_count, aperiodic, current_time);
         
         if (next_job_idx == -1) {
          
-            int next_release = hyperperiod;
-            for (int i = 0; i < job_count; i++) {
-                if (jobs[i].release > current_time && jobs[i].release < next_release && 
-                    jobs[i].remaining > 0) {
-                    next_release = jobs[i].release;
-                }
-            }
+            int next_release = next_event_time(jobs, job_count, aperiodic, current_time, 1);
             
             idle_time += (next_release - current_time);
             current_time = next_release;
@@ -183,26 +720,32 @@ void simulate_rmrcs() {
         
       
         if (current_job_idx != -1 && current_job_idx != next_job_idx && 
-            jobs[current_job_idx].remaining > 0 && 
-            has_higher_priority(jobs[next_job_idx].task_id, jobs[current_job_idx].task_id)) {
+            job_is_ready(jobs, current_job_idx, aperiodic, current_time) && 
+            job_has_higher_priority(jobs, next_job_idx, current_job_idx)) {
             
-            // Try to extend current job by QUANTUM
-            if (is_extension_feasible(current_job_idx, current_time, QUANTUM)) {
+            // RM-RCS and EDF-RCS extend the current job by QUANTUM, the other
+            // policies keep it running until the next scheduling event
+            if (dispatch_limit(jobs, current_job_idx, aperiodic, current_time) > 0 &&
+                defer_preemption(current_job_idx, next_job_idx, current_time)) {
                 int extend_time = QUANTUM;
-                if (extend_time > jobs[current_job_idx].remaining) {
-                    extend_time = jobs[current_job_idx].remaining;
+                if (policy != POLICY_RMRCS && policy != POLICY_EDFRCS) {
+                    extend_time = next_event_time(jobs, job_count, aperiodic, current_time, 0) - current_time;
+                }
+                int limit = dispatch_limit(jobs, current_job_idx, aperiodic, current_time);
+                if (extend_time > limit) {
+                    extend_time = limit;
                 }
                 
                 // Add to schedule
                 schedule[schedule_idx].task_id = jobs[current_job_idx].task_id;
-                schedule[schedule_idx].job_id = jobs[current_job_idx].job_id;
+                schedule[schedule_idx].job_id = entry_job_id(jobs, current_job_idx, aperiodic, current_time);
                 schedule[schedule_idx].start = current_time;
                 schedule[schedule_idx].end = current_time + extend_time;
                 schedule[schedule_idx].context_switch = 0;
                 schedule_idx++;
                 
-                
-                jobs[current_job_idx].remaining -= extend_time;
+                account_blocking(jobs, job_count, current_job_idx, aperiodic, current_time, extend_time);
+                consume(jobs, &job_count, current_job_idx, aperiodic, current_time, extend_time);
                 current_time += extend_time;
                 
                 continue;
@@ -218,26 +761,22 @@ void simulate_rmrcs() {
         current_job_idx = next_job_idx;
         
         
-        int next_release = hyperperiod;
-        for (int i = 0; i < job_count; i++) {
-            if (jobs[i].release > current_time && jobs[i].release < next_release) {
-                next_release = jobs[i].release;
-            }
-        }
+        int next_release = next_event_time(jobs, job_count, aperiodic, current_time, 0);
         
-        int execute_time = jobs[current_job_idx].remaining;
+        int execute_time = dispatch_limit(jobs, current_job_idx, aperiodic, current_time);
         if (next_release < current_time + execute_time) {
             execute_time = next_release - current_time;
         }
         
         schedule[schedule_idx].task_id = jobs[current_job_idx].task_id;
-        schedule[schedule_idx].job_id = jobs[current_job_idx].job_id;
+        schedule[schedule_idx].job_id = entry_job_id(jobs, current_job_idx, aperiodic, current_time);
         schedule[schedule_idx].start = current_time;
         schedule[schedule_idx].end = current_time + execute_time;
         schedule[schedule_idx].context_switch = context_switch;
         schedule_idx++;
         
-        jobs[current_job_idx].remaining -= execute_time;
+        account_blocking(jobs, job_count, current_job_idx, aperiodic, current_time, execute_time);
+        consume(jobs, &job_count, current_job_idx, aperiodic, current_time, execute_time);
         current_time += execute_time;
     }
 }
@@ -268,32 +807,22 @@ void optimize_schedule() {
 
 void calculate_metrics(FILE* fp) {
     fprintf(fp, "Turnaround Times:\n");
+    // Past a steady state the jobs repeat those one hyperperiod earlier
+    int cut = steady_state_at >= 0 ? steady_state_at + hyperperiod : sim_end;
     
     for (int t = 1; t <= task_count; t++) {
         float avg_turnaround = 0;
         int count = 0;
         
-      
-        for (int j = 1; j <= hyperperiod / tasks[t-1].period; j++) {
-            int job_id = j;
-            int release_time = tasks[t-1].arrival + (j-1) * tasks[t-1].period;
-            int completion_time = -1;
-            
-           
-            for (int i = 0; i < schedule_idx; i++) {
-                if (schedule[i].task_id == t && schedule[i].job_id == job_id) {
-                    if (completion_time < schedule[i].end) {
-                        completion_time = schedule[i].end;
-                    }
-                }
-            }
-            
-            if (completion_time != -1) {
-                int turnaround = completion_time - release_time;
-                fprintf(fp, "  T%d Job %d: %d\n", t, job_id, turnaround);
-                avg_turnaround += turnaround;
-                count++;
-            }
+        if (tasks[t-1].kind == TASK_SERVER) continue;
+        
+        for (int j = 0; j < job_count; j++) {
+            // A job still running when the simulation stopped has no turnaround
+            if (jobs[j].task_id != t || jobs[j].finish == -1 || jobs[j].release >= cut) continue;
+            int turnaround = jobs[j].finish - jobs[j].release;
+            fprintf(fp, "  T%d Job %d: %d\n", t, jobs[j].job_id, turnaround);
+            avg_turnaround += turnaround;
+            count++;
         }
         
         if (count > 0) {
@@ -303,57 +832,1428 @@ void calculate_metrics(FILE* fp) {
 }
 
 
-void print_schedule(char* filename) {
-    optimize_schedule();
-    
-    FILE* fp = fopen(filename, "w");
-    if (!fp) {
-        printf("Error opening output file\n");
-        return;
+// Response-time analysis with blocking below the tasks in the higher mask:
+// R = C + B + sum(ceil((R + Jj)/Tj) * Cj). A deferrable server can run its
+// budget at the end of one period and again at the start of the next, which
+// is a release jitter Jj of Tj - Cj. Returns the first value past the period.
+int response_time(int t, unsigned higher) {
+    int b = blocking_bound(t);
+    int r = tasks[t].wcet + b;
+    for (;;) {
+        int next = tasks[t].wcet + b;
+        for (int j = 0; j < task_count; j++) {
+            if (!(higher & (1u << j))) continue;
+            int window = r;
+            if (tasks[j].kind == TASK_SERVER && server_type == SERVER_DEFERRABLE) {
+                window += tasks[j].period - tasks[j].wcet;
+            }
+            next += (window + tasks[j].period - 1) / tasks[j].period * tasks[j].wcet;
+        }
+        if (next == r || next > tasks[t].period) return next;
+        r = next;
     }
-    
-    fprintf(fp, "Schedule (Hyperperiod: %d):\n", hyperperiod);
-    fprintf(fp, "TaskJob | Start-End | Context Switch\n");
-    
-    for (int i = 0; i < schedule_idx; i++) {
-        fprintf(fp, "T%dj%d | %d-%d", 
-               schedule[i].task_id, schedule[i].job_id, 
-               schedule[i].start, schedule[i].end);
-        
-        if (schedule[i].context_switch) {
-            fprintf(fp, " | CS");
+}
+
+// WCRT bound of task t under the current priorities
+int response_time_bound(int t) {
+    unsigned higher = 0;
+    for (int j = 0; j < task_count; j++) {
+        if (j != t && has_higher_priority(j + 1, t + 1)) higher |= 1u << j;
+    }
+    return response_time(t, higher);
+}
+
+void calculate_blocking_metrics(FILE* fp) {
+    if (resource_protocol == PROTOCOL_NONE) return;
+
+    fprintf(fp, "Blocking (%s):\n", resource_protocol == PROTOCOL_PCP ? "PCP" : "SRP");
+    for (int t = 0; t < task_count; t++) {
+        if (tasks[t].kind == TASK_SERVER) continue;
+
+        int max_blocked = 0;
+        int total_blocked = 0;
+        for (int i = 0; i < job_count; i++) {
+            if (jobs[i].task_id != t + 1) continue;
+            total_blocked += jobs[i].blocked;
+            if (jobs[i].blocked > max_blocked) max_blocked = jobs[i].blocked;
         }
-        fprintf(fp, "\n");
+
+        int wcrt = response_time_bound(t);
+        fprintf(fp, "  T%d: Bound %d, Max Observed %d, Total %d, WCRT Bound %d%s\n",
+                t + 1, blocking_bound(t), max_blocked, total_blocked, wcrt,
+                wcrt > tasks[t].period ? " (deadline miss possible)" : "");
     }
-    
-    fprintf(fp, "\nAnalysis:\n");
-    fprintf(fp, "Total Context Switches: %d\n", context_switches);
-    fprintf(fp, "Total Idle Time: %d\n", idle_time);
-    
-    calculate_metrics(fp);
-    
-    fclose(fp);
 }
 
-int main() {
-    FILE* fp = fopen("tasks.txt", "r");
-    if (!fp) {
-        printf("Error opening tasks.txt\n");
-        return 1;
+
+// RM priority levels: shorter period first, ties broken by input order
+void assign_rm_priorities() {
+    for (int i = 0; i < task_count; i++) {
+        task_priority[i] = 0;
+        for (int j = 0; j < task_count; j++) {
+            if (tasks[j].period > tasks[i].period || (tasks[j].period == tasks[i].period && j > i)) {
+                task_priority[i]++;
+            }
+        }
     }
-    
-    // Read tasks
-    while (fscanf(fp, "%d %d %d", &tasks[task_count].arrival, &tasks[task_count].wcet, &tasks[task_count].period) == 3) {
-        tasks[task_count].id = task_count + 1;
-        task_count++;
+}
+
+// Worst-case response time under preemption thresholds (Wang & Saksena):
+// blocking from one lower-priority task whose threshold reaches this task,
+// start-time interference from all higher-priority tasks and finish-time
+// interference only from tasks above the threshold, for every job in the
+// level-i busy period
+int pt_response_time(int i) {
+    long C = tasks[i].wcet;
+    long T = tasks[i].period;
+    long B = 0;
+    for (int j = 0; j < task_count; j++) {
+        if (task_priority[j] < task_priority[i] && pt_threshold[j] >= task_priority[i] && tasks[j].wcet > B) {
+            B = tasks[j].wcet;
+        }
+    }
+    if (blocking_bound(i) > B) {
+        B = blocking_bound(i); // Critical sections block through the same single window
+    }
+
+    // Level-i busy period, bounded so an overloaded set terminates
+    long limit = 2L * hyperperiod + B + C;
+    long L = B + C;
+    for (;;) {
+        long next = B;
+        for (int j = 0; j < task_count; j++) {
+            if (task_priority[j] >= task_priority[i]) {
+                next += (L + tasks[j].period - 1) / tasks[j].period * tasks[j].wcet;
+            }
+        }
+        if (next == L) break;
+        if (next > limit) return INT_MAX;
+        L = next;
+    }
+
+    long worst = 0;
+    long jobs_in_busy_period = (L + T - 1) / T;
+    for (long q = 0; q < jobs_in_busy_period; q++) {
+        long S = B + q * C;
+        for (;;) {
+            long next = B + q * C;
+            for (int j = 0; j < task_count; j++) {
+                if (task_priority[j] > task_priority[i]) {
+                    next += (1 + S / tasks[j].period) * tasks[j].wcet;
+                }
+            }
+            if (next == S) break;
+            if (next > limit) return INT_MAX;
+            S = next;
+        }
+
+        long F = S + C;
+        for (;;) {
+            long next = S + C;
+            for (int j = 0; j < task_count; j++) {
+                if (task_priority[j] > pt_threshold[i]) {
+                    long arrivals = (F + tasks[j].period - 1) / tasks[j].period - (1 + S / tasks[j].period);
+                    if (arrivals > 0) next += arrivals * tasks[j].wcet;
+                }
+            }
+            if (next == F) break;
+            if (next > limit) return INT_MAX;
+            F = next;
+        }
+
+        if (F - q * T > worst) worst = F - q * T;
+    }
+    return (int)worst;
+}
+
+int pt_all_schedulable() {
+    for (int i = 0; i < task_count; i++) {
+        if (pt_response_time(i) > tasks[i].period) return 0;
+    }
+    return 1;
+}
+
+// Optimal threshold assignment (lowest priority first, smallest threshold
+// that makes the task schedulable), then thresholds are raised as far as
+// schedulability allows, highest priority first, to cut preemptions
+void assign_preemption_thresholds() {
+    int by_priority[MAX_TASKS];
+    for (int i = 0; i < task_count; i++) {
+        pt_threshold[i] = task_priority[i];
+        by_priority[task_priority[i]] = i;
+    }
+
+    pt_schedulable = 1;
+    for (int p = 0; p < task_count; p++) {
+        int i = by_priority[p];
+        while (pt_response_time(i) > tasks[i].period) {
+            if (pt_threshold[i] == task_count - 1) {
+                pt_schedulable = 0;
+                break;
+            }
+            pt_threshold[i]++;
+        }
+        if (!pt_schedulable) return;
+    }
+
+    for (int p = task_count - 1; p >= 0; p--) {
+        int i = by_priority[p];
+        while (pt_threshold[i] < task_count - 1) {
+            pt_threshold[i]++;
+            if (!pt_all_schedulable()) {
+                pt_threshold[i]--;
+                break;
+            }
+        }
+    }
+}
+
+// Blocking tolerance (Bini & Buttazzo): the most lower-priority
+// non-preemptive execution task t absorbs, i.e. the largest slack
+// t - W(t) over the scheduling points up to its deadline
+int blocking_tolerance(int t) {
+    int best = INT_MIN;
+    for (int k = 0; k < task_count; k++) {
+        if (task_priority[k] < task_priority[t]) continue;
+        for (int point = tasks[k].period; point <= tasks[t].period; point += tasks[k].period) {
+            int candidates[2] = { point, tasks[t].period };
+            for (int c = 0; c < 2; c++) {
+                int work = 0;
+                for (int j = 0; j < task_count; j++) {
+                    if (task_priority[j] >= task_priority[t]) {
+                        work += (candidates[c] + tasks[j].period - 1) / tasks[j].period * tasks[j].wcet;
+                    }
+                }
+                if (candidates[c] - work > best) best = candidates[c] - work;
+            }
+        }
+    }
+    return best;
+}
+
+// Largest non-preemptive chunk task t may run without breaking any
+// higher-priority task
+int max_non_preemptive_chunk(int t) {
+    int chunk = tasks[t].wcet;
+    for (int k = 0; k < task_count; k++) {
+        if (task_priority[k] > task_priority[t] && blocking_tolerance(k) < chunk) {
+            chunk = blocking_tolerance(k);
+        }
+    }
+    return chunk < 0 ? 0 : chunk;
+}
+
+int longest_chunk(int t) {
+    int longest = 0;
+    for (int r = 0; r < region_count; r++) {
+        if (regions[r].task_id == t + 1 && regions[r].end - regions[r].start > longest) {
+            longest = regions[r].end - regions[r].start;
+        }
+    }
+    return longest;
+}
+
+// Tasks without declared points get evenly spaced points at the largest
+// tolerable chunk
+void place_preemption_points() {
+    for (int t = 0; t < task_count; t++) {
+        if (regions_declared[t] || tasks[t].kind == TASK_SERVER) continue;
+        int chunk = max_non_preemptive_chunk(t);
+        if (chunk < 2) continue;
+        for (int start = 0; start < tasks[t].wcet && region_count < MAX_REGIONS; start += chunk) {
+            int end = start + chunk < tasks[t].wcet ? start + chunk : tasks[t].wcet;
+            regions[region_count++] = (NonPreemptiveRegion){ t + 1, start, end };
+        }
+    }
+}
+
+// Every task must tolerate the longest chunk (or critical section) below it
+int lp_schedulable() {
+    for (int k = 0; k < task_count; k++) {
+        int B = blocking_bound(k);
+        for (int j = 0; j < task_count; j++) {
+            if (task_priority[j] < task_priority[k] && longest_chunk(j) > B) B = longest_chunk(j);
+        }
+        if (blocking_tolerance(k) < B) return 0;
+    }
+    return 1;
+}
+
+void print_preemption_points(FILE* fp) {
+    fprintf(fp, "Limited Preemption:\n");
+    for (int t = 0; t < task_count; t++) {
+        if (tasks[t].kind == TASK_SERVER) continue;
+        fprintf(fp, "  T%d: Longest Chunk %d, Max Tolerable %d, Points", t + 1,
+                longest_chunk(t), max_non_preemptive_chunk(t));
+        for (int r = 0; r < region_count; r++) {
+            if (regions[r].task_id == t + 1) fprintf(fp, " %d-%d", regions[r].start, regions[r].end);
+        }
+        fprintf(fp, "%s\n", regions_declared[t] ? " (declared)" : " (auto)");
+    }
+}
+
+double now_ns() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int largest_offset() {
+    int offset = 0;
+    for (int t = 0; t < task_count; t++) {
+        if (tasks[t].kind != TASK_SPORADIC && tasks[t].arrival > offset) offset = tasks[t].arrival;
+    }
+    return offset;
+}
+
+// Returns -1 if the first hyperperiod's jobs do not fit in MAX_JOBS
+int reset_simulation() {
+    max_offset = largest_offset();
+    horizon = max_offset + 2 * hyperperiod;
+    steady_state_at = -1;
+    horizon_cut = 0;
+    schedule_full = 0;
+    job_count = 0;
+    if (!generate_jobs(0, max_offset + hyperperiod)) return -1;
+    for (int i = 0; i < aperiodic_count; i++) {
+        aperiodic[i].remaining = aperiodic[i].exec;
+        aperiodic[i].finish = -1;
+    }
+    schedule_idx = 0;
+    context_switches = 0;
+    idle_time = 0;
+    decisions = 0;
+    return 0;
+}
+
+// EDF with SRP preemption levels (Baker): for every task, the utilization of
+// the tasks with periods up to its own plus its blocking over its period
+int edf_schedulable() {
+    for (int k = 0; k < task_count; k++) {
+        double load = (double)blocking_bound(k) / tasks[k].period;
+        for (int j = 0; j < task_count; j++) {
+            if (tasks[j].period <= tasks[k].period) load += (double)tasks[j].wcet / tasks[j].period;
+        }
+        if (load > 1.0 + 1e-9) return 0;
+    }
+    return 1;
+}
+
+// Response times of the periodic and sporadic jobs that finished
+void response_times(double* avg, int* max) {
+    long total = 0;
+    int finished = 0;
+    *max = 0;
+    for (int i = 0; i < job_count; i++) {
+        if (is_server_job(&jobs[i]) || jobs[i].finish == -1) continue;
+        int response = jobs[i].finish - jobs[i].release;
+        total += response;
+        finished++;
+        if (response > *max) *max = response;
+    }
+    *avg = finished > 0 ? (double)total / finished : 0;
+}
+
+int count_deadline_misses() {
+    int misses = 0;
+    for (int i = 0; i < job_count; i++) {
+        if (is_server_job(&jobs[i]) || jobs[i].deadline > sim_end) continue;
+        if (jobs[i].finish == -1 || jobs[i].finish > jobs[i].deadline) misses++;
+    }
+    return misses;
+}
+
+// Returns -1, with result untouched, if the jobs do not fit in MAX_JOBS
+int run_policy(int selected, PolicyResult* result) {
+    policy = selected;
+    double start = now_ns();
+    if (reset_simulation() != 0) {
+        printf("The jobs of one hyperperiod do not fit in %d\n", MAX_JOBS);
+        return -1;
+    }
+    stats_phase_end(STATS_PHASE_GENERATE, start);
+
+    start = now_ns();
+    simulate_schedule();
+    double elapsed = now_ns() - start;
+    sim_stats.phase_ns[STATS_PHASE_SIMULATE] += elapsed;
+
+    result->context_switches = context_switches;
+    result->decisions = decisions;
+    result->ns_per_decision = decisions > 0 ? elapsed / decisions : 0;
+    result->deadline_misses = count_deadline_misses();
+    response_times(&result->avg_response, &result->max_response);
+    if (selected == POLICY_PT) {
+        result->analysis_schedulable = pt_schedulable;
+    } else if (selected == POLICY_LP) {
+        result->analysis_schedulable = lp_schedulable();
+    } else if (is_edf_policy(selected)) {
+        // EDF-RCS, like RM-RCS, only defers when the simulated future stays feasible
+        result->analysis_schedulable = edf_schedulable();
+    } else {
+        // RM-RCS only defers when it is safe, so RM response-time analysis applies
+        result->analysis_schedulable = 1;
+        for (int t = 0; t < task_count; t++) {
+            if (response_time_bound(t) > tasks[t].period) result->analysis_schedulable = 0;
+        }
+    }
+    return 0;
+}
+
+const char* policy_names[POLICY_COUNT] = { "RM", "RM-RCS", "PT", "LP", "EDF", "EDF-RCS" };
+PolicyResult policy_results[POLICY_COUNT];
+int compare_policies = 0;
+
+void print_policy_comparison(FILE* fp) {
+    fprintf(fp, "Policy Comparison:\n");
+    fprintf(fp, "  %-8s %8s %10s %10s %12s %8s %8s %8s %12s\n", "Policy", "CS", "CS vs RM", "Decisions",
+            "ns/Decision", "Avg RT", "Max RT", "Misses", "Schedulable");
+    for (int p = 0; p < POLICY_COUNT; p++) {
+        int rm_cs = policy_results[POLICY_RM].context_switches;
+        float change = rm_cs > 0 ? 100.0f * (policy_results[p].context_switches - rm_cs) / rm_cs : 0;
+        fprintf(fp, "  %-8s %8d %9.1f%% %10d %12.1f %8.2f %8d %8d %12s\n", policy_names[p],
+                policy_results[p].context_switches, change, policy_results[p].decisions,
+                policy_results[p].ns_per_decision, policy_results[p].avg_response,
+                policy_results[p].max_response, policy_results[p].deadline_misses,
+                policy_results[p].analysis_schedulable ? "yes" : "no");
+    }
+}
+
+void print_preemption_thresholds(FILE* fp) {
+    fprintf(fp, "Preemption Thresholds%s:\n", pt_schedulable ? "" : " (no feasible assignment)");
+    for (int t = 0; t < task_count; t++) {
+        int wcrt = pt_response_time(t);
+        fprintf(fp, "  T%d: Priority %d, Threshold %d, WCRT ", t + 1, task_priority[t], pt_threshold[t]);
+        if (wcrt == INT_MAX) fprintf(fp, "unbounded\n");
+        else fprintf(fp, "%d\n", wcrt);
+    }
+}
+
+
+// --- Priority ordering search ---
+// Audsley's optimal priority assignment fills the levels lowest first: a
+// task may take a level if its response time fits its period with every
+// still unassigned task above it, and taking it never makes the others
+// infeasible. The search branches over those choices, so every ordering it
+// simulates passes response-time analysis; the branches are split between
+// worker processes, each with its own copy of the simulator state.
+
+#define SEARCH_GOAL_CS   0 // Fewest context switches in the simulated schedule
+#define SEARCH_GOAL_WCRT 1 // Smallest WCRT bound of one task, then fewest switches
+#define SEARCH_MAX_ORDERINGS 100000 // Simulated orderings per search, shared by the workers
+#define SEARCH_MAX_WORKERS 16
+#define SEARCH_SPLIT_LEVEL 2 // Branches at this level are dealt out to the workers
+
+typedef struct {
+    int found;
+    int objective;
+    int switches;
+    int order[MAX_TASKS]; // Task index per level, highest priority first
+    long evaluated;
+    long pruned;          // Branches cut by the analysis or the best found so far
+    int truncated;        // The ordering budget ran out
+    SimStats stats;       // What a worker process counted
+} SearchResult;
+
+int search_goal = SEARCH_GOAL_CS;
+int search_task = -1; // Task index for SEARCH_GOAL_WCRT
+int search_policy = POLICY_RMRCS;
+int search_levels[MAX_TASKS]; // Task at each level of the ordering being built, 0 is the lowest
+long search_budget = 0;
+int search_worker = 0;
+int search_workers = 1;
+int search_split = 0;
+long search_branch = 0;
+SearchResult search_best;
+
+// Response time of task t below the tasks in the higher mask, INT_MAX once
+// it exceeds the period
+int opa_response_time(int t, unsigned higher) {
+    int r = response_time(t, higher);
+    return r > tasks[t].period ? INT_MAX : r;
+}
+
+// Plain Audsley: levels[p] is the first task feasible at level p; returns 0
+// if some level has none, i.e. no fixed-priority ordering is feasible
+int audsley_assign(int* levels) {
+    unsigned unassigned = (1u << task_count) - 1;
+    for (int p = 0; p < task_count; p++) {
+        levels[p] = -1;
+        for (int t = 0; t < task_count && levels[p] == -1; t++) {
+            if ((unassigned & (1u << t)) && opa_response_time(t, unassigned & ~(1u << t)) != INT_MAX) {
+                levels[p] = t;
+            }
+        }
+        if (levels[p] == -1) return 0;
+        unassigned &= ~(1u << levels[p]);
+    }
+    return 1;
+}
+
+void apply_priority_levels(const int* levels) {
+    for (int p = 0; p < task_count; p++) {
+        task_priority[levels[p]] = p;
+    }
+    custom_priorities = 1;
+}
+
+// Periodic tasks with the same parameters are interchangeable, so only
+// orderings keeping them in input order (lowest first) are searched
+int has_identical_below(int t, unsigned unassigned) {
+    if (tasks[t].kind != TASK_PERIODIC) return 0;
+    for (int s = 0; s < t; s++) {
+        if ((unassigned & (1u << s)) && tasks[s].kind == TASK_PERIODIC && tasks[s].arrival == tasks[t].arrival &&
+            tasks[s].wcet == tasks[t].wcet && tasks[s].period == tasks[t].period) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Lower objective, then fewer switches, then the lexicographically smaller
+// order, so the answer does not depend on how the work was split
+int search_better(const SearchResult* a, const SearchResult* b) {
+    if (!a->found || !b->found) return a->found && !b->found;
+    if (a->objective != b->objective) return a->objective < b->objective;
+    if (a->switches != b->switches) return a->switches < b->switches;
+    for (int p = 0; p < task_count; p++) {
+        if (a->order[p] != b->order[p]) return a->order[p] < b->order[p];
+    }
+    return 0;
+}
+
+void search_evaluate(int objective) {
+    if (search_best.evaluated >= search_budget) {
+        search_best.truncated = 1;
+        return;
+    }
+    search_best.evaluated++;
+
+    PolicyResult result;
+    apply_priority_levels(search_levels);
+    if (run_policy(search_policy, &result) != 0) return;
+    if (result.deadline_misses > 0) return; // Cannot pass the analysis, kept as a guard
+
+    SearchResult candidate = search_best;
+    candidate.found = 1;
+    candidate.switches = result.context_switches;
+    candidate.objective = search_goal == SEARCH_GOAL_CS ? result.context_switches : objective;
+    for (int p = 0; p < task_count; p++) {
+        candidate.order[p] = search_levels[task_count - 1 - p];
+    }
+    if (search_better(&candidate, &search_best)) search_best = candidate;
+}
+
+// Fills the levels from level up with the tasks in unassigned; objective is
+// the goal's WCRT once the chosen task has a level
+void search_from_level(int level, unsigned unassigned, int objective) {
+    if (level == task_count) {
+        search_evaluate(objective);
+        return;
+    }
+    for (int t = 0; t < task_count && !search_best.truncated; t++) {
+        if (!(unassigned & (1u << t)) || has_identical_below(t, unassigned)) continue;
+        // Every worker walks the levels below the split in the same way (and
+        // only the first counts their pruning), so the bound from its own
+        // best is only used from the split up
+        if (level == search_split && search_branch++ % search_workers != search_worker) continue;
+
+        unsigned higher = unassigned & ~(1u << t);
+        int wcrt = opa_response_time(t, higher);
+        if (wcrt == INT_MAX) {
+            if (level >= search_split || search_worker == 0) search_best.pruned++;
+            continue;
+        }
+
+        int goal = objective;
+        if (search_goal == SEARCH_GOAL_WCRT && t == search_task) {
+            goal = wcrt; // Fixed now: the tasks above it are decided, their order is not
+            if (level >= search_split && search_best.found && goal > search_best.objective) {
+                search_best.pruned++;
+                continue;
+            }
+        }
+        search_levels[level] = t;
+        search_from_level(level + 1, higher, goal);
+    }
+}
+
+SearchResult search_share(int worker, int workers) {
+    SimStats before = sim_stats;
+    memset(&search_best, 0, sizeof(search_best));
+    search_worker = worker;
+    search_workers = workers;
+    search_split = task_count - 1 < SEARCH_SPLIT_LEVEL ? task_count - 1 : SEARCH_SPLIT_LEVEL;
+    search_branch = 0;
+    search_budget = SEARCH_MAX_ORDERINGS / workers;
+    search_from_level(0, (1u << task_count) - 1, 0);
+
+    search_best.stats = sim_stats;
+    search_best.stats.feasibility_calls -= before.feasibility_calls;
+    search_best.stats.events -= before.events;
+    search_best.stats.extension_iterations -= before.extension_iterations;
+    search_best.stats.feasibility_jobs -= before.feasibility_jobs;
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        search_best.stats.phase_ns[p] -= before.phase_ns[p];
+    }
+    return search_best;
+}
+
+void merge_search_result(SearchResult* total, const SearchResult* part) {
+    long evaluated = total->evaluated + part->evaluated;
+    long pruned = total->pruned + part->pruned;
+    int truncated = total->truncated || part->truncated;
+    if (search_better(part, total)) *total = *part;
+    total->evaluated = evaluated;
+    total->pruned = pruned;
+    total->truncated = truncated;
+}
+
+// Runs the shares in forked workers (in this process where fork is not
+// available or fails) and merges what they report through pipes
+SearchResult run_priority_search(int* workers_used) {
+    SearchResult total;
+    memset(&total, 0, sizeof(total));
+    int workers = 1;
+#ifndef _WIN32
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 1) workers = cpus < SEARCH_MAX_WORKERS ? (int)cpus : SEARCH_MAX_WORKERS;
+    int fds[SEARCH_MAX_WORKERS];
+    pid_t pids[SEARCH_MAX_WORKERS];
+    fflush(stdout);
+    for (int w = 0; w < workers; w++) {
+        int fd[2];
+        pids[w] = -1;
+        if (workers > 1 && pipe(fd) == 0) {
+            pids[w] = fork();
+            if (pids[w] == 0) {
+                close(fd[0]);
+                SearchResult part = search_share(w, workers);
+                ssize_t written = write(fd[1], &part, sizeof(part));
+                _exit(written == (ssize_t)sizeof(part) ? 0 : 1);
+            }
+            close(fd[1]);
+            fds[w] = fd[0];
+            if (pids[w] < 0) close(fd[0]);
+        }
+        if (pids[w] < 0) {
+            SearchResult part = search_share(w, workers);
+            merge_search_result(&total, &part);
+        }
+    }
+    for (int w = 0; w < workers; w++) {
+        if (pids[w] < 0) continue;
+        SearchResult part;
+        size_t got = 0;
+        while (got < sizeof(part)) {
+            ssize_t n = read(fds[w], (char*)&part + got, sizeof(part) - got);
+            if (n <= 0) break;
+            got += (size_t)n;
+        }
+        close(fds[w]);
+        waitpid(pids[w], NULL, 0);
+        if (got == sizeof(part)) {
+            merge_search_result(&total, &part);
+            stats_merge(&part.stats);
+        } else {
+            printf("Priority search worker %d failed, its share is missing\n", w);
+            total.truncated = 1;
+        }
+    }
+#else
+    SearchResult part = search_share(0, 1);
+    merge_search_result(&total, &part);
+#endif
+    *workers_used = workers;
+    return total;
+}
+
+void print_task_order(const int* order) {
+    for (int p = 0; p < task_count; p++) {
+        printf(" T%d", order[p] + 1);
+    }
+}
+
+// priorities.txt: "task priority" per line, task_count - 1 being the
+// highest as in task_priority
+int save_priorities(const char* filename, const char* goal) {
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Error opening %s\n", filename);
+        return -1;
+    }
+    fprintf(fp, "# Priority ordering from --search %s, highest priority first\n", goal);
+    fprintf(fp, "# task priority\n");
+    for (int p = task_count - 1; p >= 0; p--) {
+        for (int t = 0; t < task_count; t++) {
+            if (task_priority[t] == p) fprintf(fp, "%d %d\n", t + 1, p);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+int load_priorities(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        printf("Error opening %s\n", filename);
+        return -1;
+    }
+    if (section_count > 0) {
+        printf("Custom priorities are not supported with critical sections (ceilings follow RM)\n");
+        fclose(fp);
+        return -1;
+    }
+
+    int levels[MAX_TASKS];
+    int seen = 0;
+    char line[128];
+    for (int p = 0; p < task_count; p++) levels[p] = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        int t, p;
+        if (line[0] == '#' || sscanf(line, "%d %d", &t, &p) != 2) continue;
+        if (t < 1 || t > task_count || p < 0 || p >= task_count || levels[p] != -1) {
+            printf("Ignoring invalid priority line: %s", line);
+            continue;
+        }
+        levels[p] = t - 1;
+        seen |= 1 << (t - 1);
+    }
+    fclose(fp);
+
+    if (seen != (1 << task_count) - 1) {
+        printf("%s must give each of the %d tasks its own priority 0..%d\n", filename, task_count, task_count - 1);
+        return -1;
+    }
+    apply_priority_levels(levels);
+    return 0;
+}
+
+// --search cs|wcrt:N: report the RM baseline, find the best feasible
+// ordering and keep it for the run (and in priorities_path if given)
+int search_priorities(const char* goal, int selected, const char* priorities_path) {
+    if (strcmp(goal, "cs") == 0) {
+        search_goal = SEARCH_GOAL_CS;
+    } else if (sscanf(goal, "wcrt:%d", &search_task) == 1 && search_task >= 1 && search_task <= task_count &&
+               tasks[search_task-1].kind != TASK_SERVER) {
+        search_goal = SEARCH_GOAL_WCRT;
+        search_task--;
+    } else {
+        printf("Unknown search goal %s (cs or wcrt:N)\n", goal);
+        return -1;
+    }
+    if (selected != POLICY_RM && selected != POLICY_RMRCS) {
+        printf("--search needs the rm or rmrcs policy\n");
+        return -1;
+    }
+    if (section_count > 0) {
+        printf("--search is not supported with critical sections (ceilings follow RM)\n");
+        return -1;
+    }
+    search_policy = selected;
+
+    int levels[MAX_TASKS];
+    if (!audsley_assign(levels)) {
+        printf("Priority search: no fixed-priority ordering passes response-time analysis, keeping RM\n");
+        return 0;
+    }
+
+    PolicyResult rm;
+    if (run_policy(selected, &rm) != 0) return -1;
+
+    int workers;
+    double start = now_ns();
+    SearchResult best = run_priority_search(&workers);
+    double elapsed = now_ns() - start;
+
+    printf("Priority search (%s, %s): %ld orderings simulated, %ld branches pruned, %d worker%s, %.1f ms%s\n",
+           search_goal == SEARCH_GOAL_CS ? "fewest context switches" : "smallest WCRT bound",
+           policy_names[selected], best.evaluated, best.pruned, workers, workers == 1 ? "" : "s",
+           elapsed / 1e6, best.truncated ? " (budget reached, best so far)" : "");
+
+    // An in-process share leaves its last ordering behind
+    custom_priorities = 0;
+    assign_rm_priorities();
+    unsigned rm_higher = 0;
+    for (int p = 0; p < task_count; p++) {
+        levels[task_count - 1 - task_priority[p]] = p;
+        if (search_goal == SEARCH_GOAL_WCRT && has_higher_priority(p + 1, search_task + 1)) rm_higher |= 1u << p;
+    }
+    printf("  RM order:  ");
+    print_task_order(levels);
+    printf("  (CS %d", rm.context_switches);
+    if (search_goal == SEARCH_GOAL_WCRT) {
+        int wcrt = opa_response_time(search_task, rm_higher);
+        if (wcrt == INT_MAX) printf(", WCRT of T%d over its period", search_task + 1);
+        else printf(", WCRT of T%d %d", search_task + 1, wcrt);
+    }
+    printf(")\n");
+
+    if (!best.found) {
+        printf("  No ordering simulated without a deadline miss, keeping RM\n");
+        return 0;
+    }
+    for (int p = 0; p < task_count; p++) {
+        levels[p] = best.order[task_count - 1 - p];
+    }
+    apply_priority_levels(levels);
+    printf("  Best order:");
+    print_task_order(best.order);
+    printf("  (CS %d", best.switches);
+    if (search_goal == SEARCH_GOAL_WCRT) printf(", WCRT of T%d %d", search_task + 1, best.objective);
+    printf(")\n");
+
+    if (priorities_path && save_priorities(priorities_path, goal) == 0) {
+        printf("Priority ordering written to %s\n", priorities_path);
+    }
+    return 0;
+}
+
+void print_priority_ordering(FILE* fp) {
+    fprintf(fp, "Priority Ordering (custom):\n");
+    for (int p = task_count - 1; p >= 0; p--) {
+        for (int t = 0; t < task_count; t++) {
+            if (task_priority[t] != p) continue;
+            int wcrt = response_time_bound(t);
+            fprintf(fp, "  T%d: Priority %d, WCRT Bound %d%s\n", t + 1, p, wcrt,
+                    wcrt > tasks[t].period ? " (deadline miss possible)" : "");
+        }
+    }
+}
+
+
+// --- Period harmonization advisor ---
+// Every chosen period divides the candidate hyperperiod H, so the smallest
+// H for which each task has a divisor within its band is the smallest LCM.
+// Taking the largest such divisor keeps the load lowest, and longer periods
+// never hurt RM (or EDF) schedulability, so scanning H upwards and stopping
+// at the first set that passes the analysis is exact.
+
+#define HARMONIZE_MAX_TESTS 100000000L // Divisibility tests before the scan gives up
+
+// Percent by which each task's period may shrink: "10" for every task or
+// "10,5,0" per task, the last value repeating; -1 on a malformed list
+int parse_tolerances(const char* spec, double* pct) {
+    const char* p = spec;
+    double last = 0;
+    for (int t = 0; t < task_count; t++) {
+        if (*p) {
+            char* end;
+            last = strtod(p, &end);
+            if (end == p || last < 0 || last >= 100 || (*end != ',' && *end != '\0')) return -1;
+            p = *end == ',' ? end + 1 : end;
+        }
+        pct[t] = last;
+    }
+    return 0;
+}
+
+// The analysis behind the policy: Baker's test for EDF, response-time
+// analysis for the fixed-priority policies
+int periods_schedulable(int selected) {
+    update_resource_ceilings();
+    if (is_edf_policy(selected)) return edf_schedulable();
+    if (!custom_priorities) assign_rm_priorities();
+    for (int t = 0; t < task_count; t++) {
+        if (response_time_bound(t) > tasks[t].period) return 0;
+    }
+    return 1;
+}
+
+double total_utilization() {
+    double u = 0;
+    for (int t = 0; t < task_count; t++) {
+        u += (double)tasks[t].wcet / tasks[t].period;
+    }
+    return u;
+}
+
+// Jobs generate_jobs() creates for releases before end
+long count_jobs(int end) {
+    long count = 0;
+    for (int t = 0; t < task_count; t++) {
+        if (tasks[t].kind == TASK_SPORADIC) {
+            for (int j = 0; j < sporadic_release_count[t]; j++) {
+                if (sporadic_releases[t][j] < end) count++;
+            }
+        } else if (tasks[t].kind == TASK_SERVER && server_type == SERVER_SPORADIC) {
+            count++;
+        } else if (tasks[t].arrival < end) {
+            count += (end - tasks[t].arrival + tasks[t].period - 1) / tasks[t].period;
+        }
+    }
+    return count;
+}
+
+// Best of a few runs of the whole simulation, in ns
+double time_simulation(int selected) {
+    PolicyResult result;
+    double best = 0;
+    for (int i = 0; i < 5; i++) {
+        double start = now_ns();
+        run_policy(selected, &result);
+        double elapsed = now_ns() - start;
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// --harmonize SPEC: propose shorter periods with the smallest hyperperiod;
+// the tasks are left as they were
+void advise_periods(const char* spec, int selected) {
+    double pct[MAX_TASKS];
+    if (parse_tolerances(spec, pct) != 0) {
+        printf("Invalid tolerance list %s (percentages, e.g. 10 or 10,5,0)\n", spec);
+        return;
+    }
+
+    int original[MAX_TASKS];
+    int lo[MAX_TASKS];
+    int proposed[MAX_TASKS];
+    int order[MAX_TASKS];
+    int adjustable = 0;
+    int step = 1;  // LCM of the fixed periods, H must be a multiple of it
+    int start = 1;
+    for (int t = 0; t < task_count; t++) {
+        original[t] = tasks[t].period;
+        lo[t] = original[t];
+        if (tasks[t].kind == TASK_PERIODIC) {
+            lo[t] = (int)ceil(original[t] * (100 - pct[t]) / 100);
+            if (lo[t] < 1) lo[t] = 1;
+        }
+        if (lo[t] == original[t]) {
+            step = lcm(step, original[t]);
+        } else {
+            // Narrowest bands first, they reject the most candidates
+            int k = adjustable++;
+            while (k > 0 && original[order[k-1]] - lo[order[k-1]] > original[t] - lo[t]) {
+                order[k] = order[k-1];
+                k--;
+            }
+            order[k] = t;
+        }
+        if (lo[t] > start) start = lo[t];
+    }
+
+    int original_h = hyperperiod;
+    double original_u = total_utilization();
+    long original_jobs = count_jobs(hyperperiod);
+
+    int found = 0;
+    long tests = 0;
+    for (long h = (start + step - 1) / step * step; h < original_h && !found && tests < HARMONIZE_MAX_TESTS; h += step) {
+        int fits = 1;
+        for (int k = 0; k < adjustable && fits; k++) {
+            int t = order[k];
+            int d = original[t] < h ? original[t] : (int)h;
+            while (d >= lo[t] && (tests++, h % d != 0)) d--;
+            if (d < lo[t]) fits = 0;
+            else tasks[t].period = d;
+        }
+        if (!fits) continue;
+        hyperperiod = (int)h;
+        if (periods_schedulable(selected)) {
+            found = (int)h;
+            for (int t = 0; t < task_count; t++) proposed[t] = tasks[t].period;
+        }
+    }
+
+    printf("Period harmonization (%s):", policy_names[selected]);
+    if (!found) {
+        printf(" no shorter hyperperiod than %d within the bands%s\n", original_h,
+               tests >= HARMONIZE_MAX_TESTS ? " (scan stopped early)" : "");
+    } else {
+        printf(" hyperperiod %d -> %d (%.1fx smaller)\n", original_h, found, (double)original_h / found);
+        for (int t = 0; t < task_count; t++) {
+            if (proposed[t] == original[t]) printf("  T%d: period %d (unchanged)\n", t + 1, original[t]);
+            else printf("  T%d: period %d -> %d (-%.1f%%)\n", t + 1, original[t], proposed[t],
+                        100.0 * (original[t] - proposed[t]) / original[t]);
+        }
+
+        // PT and LP set up thresholds and points for the original periods
+        int timed = (selected == POLICY_PT || selected == POLICY_LP) ? POLICY_RMRCS : selected;
+        hyperperiod = found;
+        long proposed_jobs = count_jobs(hyperperiod);
+        printf("  Utilization %.3f -> %.3f, jobs per hyperperiod %ld -> %ld (%.1fx fewer)\n",
+               original_u, total_utilization(), original_jobs, proposed_jobs, (double)original_jobs / proposed_jobs);
+        if (count_jobs(largest_offset() + original_h) > MAX_JOBS) {
+            printf("  %s simulation not timed: the original periods need more than %d jobs\n",
+                   policy_names[timed], MAX_JOBS);
+        } else {
+            double after = time_simulation(timed);
+            for (int t = 0; t < task_count; t++) tasks[t].period = original[t];
+            hyperperiod = original_h;
+            periods_schedulable(selected);
+            double before = time_simulation(timed);
+            printf("  %s simulation %.3f ms -> %.3f ms (%.1fx faster)\n", policy_names[timed],
+                   before / 1e6, after / 1e6, after > 0 ? before / after : 0);
+        }
+    }
+
+    for (int t = 0; t < task_count; t++) tasks[t].period = original[t];
+    hyperperiod = original_h;
+    update_resource_ceilings();
+    if (!custom_priorities) assign_rm_priorities();
+}
+
+
+int compare_ints(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+// Nearest-rank percentile over a sorted array
+int percentile(const int* sorted, int n, int p) {
+    int rank = (p * n + 99) / 100;
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+void calculate_aperiodic_metrics(FILE* fp) {
+    static const char* server_names[] = { "None", "Polling", "Deferrable", "Sporadic" };
+    int responses[MAX_APERIODIC];
+    int served = 0;
+    float avg_response = 0;
+
+    if (aperiodic_count == 0) return;
+
+    int server = -1;
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i].kind == TASK_SERVER) server = i;
+    }
+
+    fprintf(fp, "Aperiodic Response Times");
+    if (server != -1) {
+        fprintf(fp, " (%s Server T%d: Period=%d, Budget=%d)", server_names[server_type],
+                server + 1, tasks[server].period, tasks[server].wcet);
+    }
+    fprintf(fp, ":\n");
+
+    for (int i = 0; i < aperiodic_count; i++) {
+        if (aperiodic[i].remaining > 0) {
+            fprintf(fp, "  A%d (arrival %d): not served\n", i + 1, aperiodic[i].arrival);
+            continue;
+        }
+        int response = aperiodic[i].finish - aperiodic[i].arrival;
+        fprintf(fp, "  A%d (arrival %d): %d\n", i + 1, aperiodic[i].arrival, response);
+        responses[served++] = response;
+        avg_response += response;
+    }
+
+    fprintf(fp, "  Served: %d/%d\n", served, aperiodic_count);
+    if (served > 0) {
+        qsort(responses, served, sizeof(int), compare_ints);
+        fprintf(fp, "  Average: %.2f  P50: %d  P90: %d  P99: %d  Max: %d\n",
+                avg_response / served,
+                percentile(responses, served, 50), percentile(responses, served, 90),
+                percentile(responses, served, 99), responses[served - 1]);
+    }
+}
+
+
+void print_schedule(const char* filename) {
+    double start = stats_now_ns();
+    optimize_schedule();
+    stats_phase_end(STATS_PHASE_OPTIMIZE, start);
+    start = stats_now_ns();
+    
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        printf("Error opening output file\n");
+        return;
+    }
+    
+    fprintf(fp, "Schedule (Hyperperiod: %d):\n", hyperperiod);
+    fprintf(fp, "TaskJob | Start-End | Context Switch\n");
+    
+    for (int i = 0; i < schedule_idx; i++) {
+        if (tasks[schedule[i].task_id-1].kind == TASK_SERVER) {
+            fprintf(fp, "A%d | %d-%d",
+                   schedule[i].job_id, schedule[i].start, schedule[i].end);
+        } else {
+            fprintf(fp, "T%dj%d | %d-%d", 
+                   schedule[i].task_id, schedule[i].job_id, 
+                   schedule[i].start, schedule[i].end);
+        }
+        
+        if (schedule[i].context_switch) {
+            fprintf(fp, " | CS");
+        }
+        fprintf(fp, "\n");
+    }
+    
+    fprintf(fp, "\nAnalysis:\n");
+    fprintf(fp, "Total Context Switches: %d\n", context_switches);
+    fprintf(fp, "Total Idle Time: %d\n", idle_time);
+    if (steady_state_at != 0 || sim_end != hyperperiod) {
+        fprintf(fp, "Simulated: 0-%d, ", sim_end);
+        if (steady_state_at >= 0) {
+            fprintf(fp, "repeats every %d from %d (steady state)\n", hyperperiod, steady_state_at);
+        } else if (horizon_cut) {
+            fprintf(fp, "cut short by MAX_JOBS (%d jobs), no steady state yet\n", MAX_JOBS);
+        } else if (schedule_full) {
+            fprintf(fp, "cut short by the schedule table (%d entries), no steady state yet\n", MAX_JOBS * 2);
+        } else {
+            fprintf(fp, "no steady state up to max offset + 2H\n");
+        }
+    }
+    
+    calculate_metrics(fp);
+    calculate_blocking_metrics(fp);
+    calculate_aperiodic_metrics(fp);
+    if (custom_priorities) {
+        print_priority_ordering(fp);
+    }
+    if (policy == POLICY_PT || compare_policies) {
+        print_preemption_thresholds(fp);
+    }
+    if (policy == POLICY_LP || compare_policies) {
+        print_preemption_points(fp);
+    }
+    if (compare_policies) {
+        print_policy_comparison(fp);
+    }
+    
+    fclose(fp);
+    stats_phase_end(STATS_PHASE_REPORT, start);
+}
+
+// One track per task, one slice per schedule entry, context switches and
+// deadline misses as instant events; a time unit is shown as 1 ms
+#define TRACE_US_PER_UNIT 1000
+
+void export_trace(const char* filename, const char* tasks_path) {
+    TraceWriter tw;
+    char name[96];
+    snprintf(name, sizeof(name), "%s schedule of %s", policy_names[policy], tasks_path);
+    if (trace_open(&tw, filename, name) != 0) return;
+
+    for (int t = 0; t < task_count; t++) {
+        if (tasks[t].kind == TASK_SERVER) {
+            snprintf(name, sizeof(name), "Server T%d (C=%d, T=%d)", t + 1, tasks[t].wcet, tasks[t].period);
+        } else {
+            snprintf(name, sizeof(name), "T%d (C=%d, T=%d)", t + 1, tasks[t].wcet, tasks[t].period);
+        }
+        trace_track(&tw, t + 1, name, t + 1);
+    }
+
+    int previous = 0;
+    for (int i = 0; i < schedule_idx; i++) {
+        const ScheduleEntry* e = &schedule[i];
+        if (tasks[e->task_id-1].kind == TASK_SERVER) {
+            snprintf(name, sizeof(name), "A%d", e->job_id);
+        } else {
+            snprintf(name, sizeof(name), "T%dj%d", e->task_id, e->job_id);
+        }
+        trace_slice(&tw, e->task_id, name, (long long)e->start * TRACE_US_PER_UNIT,
+                    (long long)(e->end - e->start) * TRACE_US_PER_UNIT);
+        if (e->context_switch) {
+            trace_instant(&tw, e->task_id, "CS", (long long)e->start * TRACE_US_PER_UNIT, "from_task", previous);
+        }
+        previous = e->task_id;
+    }
+
+    for (int i = 0; i < job_count; i++) {
+        if (is_server_job(&jobs[i]) || jobs[i].deadline > sim_end) continue;
+        if (jobs[i].finish == -1 || jobs[i].finish > jobs[i].deadline) {
+            trace_instant(&tw, jobs[i].task_id, "Deadline miss",
+                          (long long)jobs[i].deadline * TRACE_US_PER_UNIT, "job", jobs[i].job_id);
+        }
+    }
+
+    long long events = trace_close(&tw);
+    if (events < 0) {
+        printf("Error writing trace file %s\n", filename);
+    } else {
+        printf("Trace with %lld events written to %s\n", events, filename);
+    }
+}
+
+// sporadic.txt: one task per line, "wcet min_interarrival release..."
+void load_sporadic_tasks(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) return;
+
+    char line[512];
+    while (fgets(line, sizeof(line), fp) && task_count < MAX_TASKS) {
+        char* p = line;
+        char* end;
+        int wcet = strtol(p, &end, 10);
+        if (end == p) continue;
+        p = end;
+        int mit = strtol(p, &end, 10);
+        if (end == p || mit <= 0) continue;
+        p = end;
+
+        int i = task_count;
+        tasks[i] = (Task){ i + 1, -1, wcet, mit, TASK_SPORADIC };
+        sporadic_release_count[i] = 0;
+
+        for (;;) {
+            int release = strtol(p, &end, 10);
+            if (end == p || sporadic_release_count[i] >= MAX_SPORADIC_RELEASES) break;
+            p = end;
+
+            int n = sporadic_release_count[i];
+            if (n > 0 && release < sporadic_releases[i][n-1] + mit) {
+                printf("T%d: release %d violates minimum inter-arrival %d, delayed to %d\n",
+                       i + 1, release, mit, sporadic_releases[i][n-1] + mit);
+                release = sporadic_releases[i][n-1] + mit;
+            }
+            sporadic_releases[i][n] = release;
+            sporadic_release_count[i]++;
+        }
+
+        if (sporadic_release_count[i] > 0) {
+            tasks[i].arrival = sporadic_releases[i][0];
+        }
+        task_count++;
+    }
+    fclose(fp);
+}
+
+// server.txt: "polling|deferrable|sporadic period budget"; the period sets
+// the server's RM priority
+void load_server(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) return;
+
+    char type[16];
+    int period, budget;
+    if (fscanf(fp, "%15s %d %d", type, &period, &budget) == 3 && task_count < MAX_TASKS) {
+        if (strcmp(type, "polling") == 0) server_type = SERVER_POLLING;
+        else if (strcmp(type, "deferrable") == 0) server_type = SERVER_DEFERRABLE;
+        else if (strcmp(type, "sporadic") == 0) server_type = SERVER_SPORADIC;
+        else printf("Unknown server type '%s' in %s\n", type, filename);
+
+        if (server_type != SERVER_NONE) {
+            tasks[task_count] = (Task){ task_count + 1, 0, budget, period, TASK_SERVER };
+            task_count++;
+        }
+    }
+    fclose(fp);
+}
+
+// resources.txt: protocol name ("pcp" or "srp") followed by one critical
+// section per line, "task resource offset length" (offset into the job's WCET)
+void load_resources(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) return;
+
+    char protocol[16];
+    if (fscanf(fp, "%15s", protocol) != 1) {
+        fclose(fp);
+        return;
+    }
+    if (strcmp(protocol, "pcp") == 0) resource_protocol = PROTOCOL_PCP;
+    else if (strcmp(protocol, "srp") == 0) resource_protocol = PROTOCOL_SRP;
+    else {
+        printf("Unknown resource protocol '%s' in %s\n", protocol, filename);
+        fclose(fp);
+        return;
+    }
+
+    CriticalSection cs;
+    while (section_count < MAX_SECTIONS &&
+           fscanf(fp, "%d %d %d %d", &cs.task_id, &cs.resource, &cs.offset, &cs.length) == 4) {
+        if (cs.task_id < 1 || cs.task_id > task_count || tasks[cs.task_id-1].kind == TASK_SERVER ||
+            cs.resource < 1 || cs.resource > MAX_RESOURCES || cs.offset < 0 || cs.length <= 0 ||
+            cs.offset + cs.length > tasks[cs.task_id-1].wcet) {
+            printf("Ignoring invalid critical section: T%d R%d %d+%d\n",
+                   cs.task_id, cs.resource, cs.offset, cs.length);
+            continue;
+        }
+        sections[section_count++] = cs;
+    }
+    fclose(fp);
+    update_resource_ceilings();
+}
+
+// preemption.txt: "task points p1 p2 ..." (preemptible only at those
+// execution offsets) or "task region start length" (one non-preemptive region)
+void load_preemption_points(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) return;
+
+    char line[512];
+    while (fgets(line, sizeof(line), fp)) {
+        char* p = line;
+        char* end;
+        char kind[16];
+        int n;
+        int t = strtol(p, &end, 10);
+        if (end == p || sscanf(end, "%15s%n", kind, &n) != 1) continue;
+        p = end + n;
+
+        if (t < 1 || t > task_count || tasks[t-1].kind == TASK_SERVER) {
+            printf("Ignoring preemption points for unknown task T%d\n", t);
+            continue;
+        }
+        int wcet = tasks[t-1].wcet;
+
+        if (strcmp(kind, "region") == 0) {
+            int start, length;
+            if (sscanf(p, "%d %d", &start, &length) != 2 || start < 0 || length <= 0 ||
+                start + length > wcet || region_count >= MAX_REGIONS) {
+                printf("Ignoring invalid non-preemptive region for T%d\n", t);
+                continue;
+            }
+            regions[region_count++] = (NonPreemptiveRegion){ t, start, start + length };
+        } else if (strcmp(kind, "points") == 0) {
+            // Chunks between consecutive points (and the job's start and end)
+            int previous = 0;
+            int done = 0;
+            while (!done) {
+                int point = strtol(p, &end, 10);
+                if (end == p) {
+                    point = wcet; // The job's end closes the last chunk
+                    done = 1;
+                }
+                p = end;
+                if (point <= previous || point > wcet) {
+                    if (!done) printf("Ignoring preemption point %d for T%d\n", point, t);
+                    continue;
+                }
+                if (region_count < MAX_REGIONS) {
+                    regions[region_count++] = (NonPreemptiveRegion){ t, previous, point };
+                }
+                previous = point;
+            }
+        } else {
+            printf("Unknown preemption declaration '%s' for T%d\n", kind, t);
+            continue;
+        }
+        regions_declared[t-1] = 1;
+    }
+    fclose(fp);
+}
+
+int compare_arrivals(const void* a, const void* b) {
+    return ((const AperiodicJob*)a)->arrival - ((const AperiodicJob*)b)->arrival;
+}
+
+// aperiodic.txt: "arrival exec_time" per request
+void load_aperiodic_jobs(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) return;
+
+    AperiodicJob* a = &aperiodic[aperiodic_count];
+    while (aperiodic_count < MAX_APERIODIC && fscanf(fp, "%d %d", &a->arrival, &a->exec) == 2) {
+        a->remaining = a->exec;
+        a->finish = -1;
+        aperiodic_count++;
+        a = &aperiodic[aperiodic_count];
+    }
+    fclose(fp);
+
+    qsort(aperiodic, aperiodic_count, sizeof(AperiodicJob), compare_arrivals);
+    if (aperiodic_count > 0 && server_type == SERVER_NONE) {
+        printf("Warning: %s given without server.txt, aperiodic requests are not served\n", filename);
+    }
+}
+
+int main(int argc, char** argv) {
+    double program_start = stats_now_ns();
+    CliOptions opts = { .tasks_path = "tasks.txt", .output_path = "schedule.txt",
+                        .sporadic_path = "sporadic.txt", .aperiodic_path = "aperiodic.txt",
+                        .server_path = "server.txt", .resources_path = "resources.txt",
+                        .format = TASKSET_FORMAT_AUTO, .policy = "rmrcs",
+                        .preemption_path = "preemption.txt" };
+    unsigned accepted = CLI_SPORADIC | CLI_APERIODIC | CLI_SERVER | CLI_RESOURCES |
+                        CLI_PREEMPTION | CLI_POLICY | CLI_COMPARE | CLI_TRACE | CLI_SEARCH |
+                        CLI_PRIORITIES | CLI_HARMONIZE | CLI_STATS;
+    int status = parse_cli_options(argc, argv, accepted, &opts);
+    if (status != 0) {
+        return status < 0 ? 1 : 0;
+    }
+    
+    int selected = -1;
+    if (strcmp(opts.policy, "rm") == 0) selected = POLICY_RM;
+    else if (strcmp(opts.policy, "rmrcs") == 0) selected = POLICY_RMRCS;
+    else if (strcmp(opts.policy, "pt") == 0) selected = POLICY_PT;
+    else if (strcmp(opts.policy, "lp") == 0) selected = POLICY_LP;
+    else if (strcmp(opts.policy, "edf") == 0) selected = POLICY_EDF;
+    else if (strcmp(opts.policy, "edfrcs") == 0) selected = POLICY_EDFRCS;
+    else {
+        printf("Unknown policy %s\n", opts.policy);
+        return 1;
+    }
+    compare_policies = opts.compare;
+    
+    // Read tasks
+    TaskSet set;
+    double load_phase = stats_now_ns();
+    clock_t load_start = clock();
+    if (load_taskset(opts.tasks_path, opts.format, &set) != 0) {
+        return 1;
+    }
+    printf("Loaded %d tasks from %s (%s format) in %.3f ms\n", set.count, opts.tasks_path,
+           taskset_format_name(set.format), 1000.0 * (clock() - load_start) / CLOCKS_PER_SEC);
+    if (set.count == 0 || set.count > MAX_TASKS) {
+        printf("Simulator supports 1 to %d tasks\n", MAX_TASKS);
+        free_taskset(&set);
+        return 1;
+    }
+    for (int i = 0; i < set.count; i++) {
+        tasks[task_count] = (Task){ task_count + 1, set.tasks[i].arrival, set.tasks[i].wcet,
+                                    set.tasks[i].period, TASK_PERIODIC };
+        task_count++;
+    }
+    free_taskset(&set);
+    
+    // Optional event-driven load
+    load_sporadic_tasks(opts.sporadic_path);
+    load_server(opts.server_path);
+    load_resources(opts.resources_path);
+    load_preemption_points(opts.preemption_path);
+    load_aperiodic_jobs(opts.aperiodic_path);
+    stats_phase_end(STATS_PHASE_LOAD, load_phase);
+    
+    calculate_hyperperiod();
+    assign_rm_priorities();
+    // Refuse an oversized set before any step simulates it
+    long needed = count_jobs(largest_offset() + hyperperiod);
+    if (needed > MAX_JOBS) {
+        if (opts.harmonize) {
+            advise_periods(opts.harmonize, selected);
+        }
+        printf("Hyperperiod %d needs %ld jobs, the simulator holds %d (see --harmonize)\n",
+               hyperperiod, needed, MAX_JOBS);
+        return 1;
+    }
+    if (opts.search) {
+        if (search_priorities(opts.search, selected, opts.priorities_path) != 0) return 1;
+    } else if (opts.priorities_path && load_priorities(opts.priorities_path) != 0) {
+        return 1;
+    }
+    if (selected == POLICY_PT || compare_policies) {
+        assign_preemption_thresholds();
+    }
+    if (selected == POLICY_LP || compare_policies) {
+        place_preemption_points();
+    }
+    if (opts.harmonize) {
+        advise_periods(opts.harmonize, selected);
+    }
+    if (compare_policies) {
+        for (int p = 0; p < POLICY_COUNT; p++) {
+            if (run_policy(p, &policy_results[p]) != 0) return 1;
+        }
+        print_policy_comparison(stdout);
+    }
+    
+    PolicyResult result;
+    if (run_policy(selected, &result) != 0) return 1;
+    print_schedule(opts.output_path);
+    if (opts.trace_path) {
+        double trace_start = stats_now_ns();
+        export_trace(opts.trace_path, opts.tasks_path);
+        stats_phase_end(STATS_PHASE_REPORT, trace_start);
+    }
+    
+    printf("Simulation complete. Results written to %s\n", opts.output_path);
+    if (opts.stats_path) {
+        write_stats_json(opts.stats_path, "main_wcet_only", policy_names[selected], task_count,
+                         hyperperiod, stats_now_ns() - program_start);
     }
-    fclose(fp);
-    
-    calculate_hyperperiod();
-    generate_jobs();
-    simulate_rmrcs();
-    print_schedule("schedule.txt");
-    
-    printf("Simulation complete. Results written to schedule.txt\n");
     return 0;
 }
@@ -0,0 +1,64 @@
+#include "sim_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+SimStats sim_stats;
+
+static const char* phase_names[STATS_PHASE_COUNT] = { "load", "generate", "simulate", "optimize", "report" };
+
+double stats_now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void stats_phase_end(int phase, double start) {
+    sim_stats.phase_ns[phase] += stats_now_ns() - start;
+}
+
+void stats_merge(const SimStats* part) {
+    sim_stats.feasibility_calls += part->feasibility_calls;
+    sim_stats.events += part->events;
+    sim_stats.extension_iterations += part->extension_iterations;
+    sim_stats.feasibility_jobs += part->feasibility_jobs;
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        sim_stats.phase_ns[p] += part->phase_ns[p];
+    }
+}
+
+int write_stats_json(const char* path, const char* program, const char* policy,
+                     int task_count, int hyperperiod, double total_ns) {
+    int to_stdout = strcmp(path, "-") == 0;
+    FILE* fp = to_stdout ? stdout : fopen(path, "w");
+    if (!fp) {
+        printf("Error opening stats file %s\n", path);
+        return -1;
+    }
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"program\": \"%s\",\n", program);
+    if (policy) fprintf(fp, "  \"policy\": \"%s\",\n", policy);
+    fprintf(fp, "  \"tasks\": %d,\n", task_count);
+    fprintf(fp, "  \"hyperperiod\": %d,\n", hyperperiod);
+    fprintf(fp, "  \"counters\": {\n");
+    fprintf(fp, "    \"feasibility_calls\": %lld,\n", sim_stats.feasibility_calls);
+    fprintf(fp, "    \"events\": %lld,\n", sim_stats.events);
+    fprintf(fp, "    \"extension_search_iterations\": %lld,\n", sim_stats.extension_iterations);
+    fprintf(fp, "    \"feasibility_jobs_simulated\": %lld\n", sim_stats.feasibility_jobs);
+    fprintf(fp, "  },\n");
+    fprintf(fp, "  \"phases_ms\": {\n");
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        fprintf(fp, "    \"%s\": %.3f%s\n", phase_names[p], sim_stats.phase_ns[p] / 1e6,
+                p + 1 < STATS_PHASE_COUNT ? "," : "");
+    }
+    fprintf(fp, "  },\n");
+    fprintf(fp, "  \"total_ms\": %.3f\n", total_ns / 1e6);
+    fprintf(fp, "}\n");
+
+    if (to_stdout) {
+        fflush(fp);
+        return 0;
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
@@ -0,0 +1,36 @@
+#ifndef SIM_STATS_H
+#define SIM_STATS_H
+
+// Always-on profiling counters and phase timers shared by the simulators.
+// Counting is a plain increment and phases are timed once each, so the cost
+// does not depend on whether --stats asks for the JSON report.
+
+#define STATS_PHASE_LOAD     0 // Task set and optional input files
+#define STATS_PHASE_GENERATE 1 // Job generation
+#define STATS_PHASE_SIMULATE 2 // Scheduling loop, feasibility checks included
+#define STATS_PHASE_OPTIMIZE 3 // Merging adjacent schedule entries
+#define STATS_PHASE_REPORT   4 // Output file and trace
+#define STATS_PHASE_COUNT    5
+
+typedef struct {
+    long long feasibility_calls;      // is_extension_feasible() calls
+    long long events;                 // Iterations of the main scheduling loop
+    long long extension_iterations;   // Binary-search steps in find_max_extension(); 0 in main_wcet_only
+    long long feasibility_jobs;       // Jobs dispatched inside is_extension_feasible()
+    double phase_ns[STATS_PHASE_COUNT];
+} SimStats;
+
+extern SimStats sim_stats;
+
+double stats_now_ns(void);
+// Adds the time since start (from stats_now_ns()) to a phase
+void stats_phase_end(int phase, double start);
+// Adds the counters and phase times of part, e.g. from a worker process
+void stats_merge(const SimStats* part);
+
+// Writes the report as JSON to path, "-" for stdout; total_ns is the run
+// time of the whole program. Returns -1 if the file cannot be written.
+int write_stats_json(const char* path, const char* program, const char* policy,
+                     int task_count, int hyperperiod, double total_ns);
+
+#endif // SIM_STATS_H
@@ -0,0 +1,432 @@
+#include "taskset_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file, parsed in place without copying
+typedef struct {
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+static int map_file(const char* path, MappedFile* mf) {
+    mf->data = NULL;
+    mf->size = 0;
+#ifdef _WIN32
+    mf->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mf->file == INVALID_HANDLE_VALUE) return -1;
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(mf->file, &size);
+    mf->size = (size_t)size.QuadPart;
+    mf->mapping = NULL;
+    if (mf->size == 0) return 0;
+
+    mf->mapping = CreateFileMappingA(mf->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mf->mapping) {
+        mf->data = (const char*)MapViewOfFile(mf->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!mf->data) {
+        if (mf->mapping) CloseHandle(mf->mapping);
+        CloseHandle(mf->file);
+        return -1;
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    mf->size = (size_t)st.st_size;
+    if (mf->size > 0) {
+        void* p = mmap(NULL, mf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(p, mf->size, MADV_SEQUENTIAL);
+        mf->data = (const char*)p;
+    }
+    close(fd);
+#endif
+    return 0;
+}
+
+static void unmap_file(MappedFile* mf) {
+#ifdef _WIN32
+    if (mf->data) UnmapViewOfFile(mf->data);
+    if (mf->mapping) CloseHandle(mf->mapping);
+    CloseHandle(mf->file);
+#else
+    if (mf->data) munmap((void*)mf->data, mf->size);
+#endif
+}
+
+typedef struct {
+    const char* p;
+    const char* end;
+    int line;
+} Cursor;
+
+// Skips blanks and '#' comments; stops at a newline when stop_at_newline is set
+static void skip_space(Cursor* c, int stop_at_newline) {
+    while (c->p < c->end) {
+        char ch = *c->p;
+        if (ch == '#') {
+            while (c->p < c->end && *c->p != '\n') c->p++;
+        } else if (ch == '\n') {
+            if (stop_at_newline) return;
+            c->line++;
+            c->p++;
+        } else if (ch == ' ' || ch == '\t' || ch == '\r') {
+            c->p++;
+        } else {
+            return;
+        }
+    }
+}
+
+// Returns 1 and stores the value, 0 at end of input, -1 on a malformed token
+static int parse_int(Cursor* c, int* value) {
+    skip_space(c, 0);
+    if (c->p >= c->end) return 0;
+
+    int negative = 0;
+    if (*c->p == '-') {
+        negative = 1;
+        c->p++;
+    }
+    if (c->p >= c->end || *c->p < '0' || *c->p > '9') return -1;
+
+    long v = 0;
+    while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+        v = v * 10 + (*c->p - '0');
+        if (v > 0x7fffffffL) return -1;
+        c->p++;
+    }
+    if (c->p < c->end && *c->p != ' ' && *c->p != '\t' && *c->p != '\r' &&
+        *c->p != '\n' && *c->p != '#') return -1;
+
+    *value = negative ? (int)-v : (int)v;
+    return 1;
+}
+
+// Decimal number without exponent, enough for actual execution times
+static int parse_float(Cursor* c, float* value) {
+    skip_space(c, 0);
+    if (c->p >= c->end) return 0;
+
+    const char* start = c->p;
+    double v = 0;
+    double scale = 1;
+    int negative = 0;
+    if (*c->p == '-') {
+        negative = 1;
+        c->p++;
+    }
+    while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+        v = v * 10 + (*c->p - '0');
+        c->p++;
+    }
+    if (c->p < c->end && *c->p == '.') {
+        c->p++;
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            scale /= 10;
+            v += (*c->p - '0') * scale;
+            c->p++;
+        }
+    }
+    if (c->p == start || (negative && c->p == start + 1)) return -1;
+
+    *value = (float)(negative ? -v : v);
+    return 1;
+}
+
+// A file whose first line holds a single number is in the counted format
+static int detect_format(const char* data, size_t size) {
+    Cursor c = { data, data + size, 1 };
+    int numbers = 0;
+    int value;
+
+    skip_space(&c, 0);
+    for (;;) {
+        skip_space(&c, 1);
+        if (c.p >= c.end || *c.p == '\n') break;
+        if (parse_int(&c, &value) != 1) break;
+        numbers++;
+    }
+    return numbers == 1 ? TASKSET_FORMAT_COUNTED : TASKSET_FORMAT_PLAIN;
+}
+
+const char* taskset_format_name(int format) {
+    switch (format) {
+    case TASKSET_FORMAT_PLAIN: return "plain";
+    case TASKSET_FORMAT_COUNTED: return "counted";
+    default: return "auto";
+    }
+}
+
+int load_taskset(const char* path, int format, TaskSet* set) {
+    MappedFile mf;
+    set->tasks = NULL;
+    set->count = 0;
+
+    if (map_file(path, &mf) != 0) {
+        printf("Error opening %s\n", path);
+        return -1;
+    }
+
+    if (format == TASKSET_FORMAT_AUTO) {
+        format = detect_format(mf.data, mf.size);
+    }
+    set->format = format;
+
+    Cursor c = { mf.data, mf.data + mf.size, 1 };
+    int expected = -1;
+    if (format == TASKSET_FORMAT_COUNTED) {
+        if (parse_int(&c, &expected) != 1 || expected < 0) {
+            printf("%s:%d: expected the number of tasks\n", path, c.line);
+            unmap_file(&mf);
+            return -1;
+        }
+    }
+
+    // "0 0 1\n" is the shortest possible task line, so the file size bounds
+    // the task count, also the one a counted file announces
+    size_t max_tasks = mf.size / 6 + 1;
+    if (expected >= 0 && (size_t)expected > max_tasks) {
+        printf("%s: %d tasks announced, but the file holds at most %zu\n", path, expected, max_tasks);
+        unmap_file(&mf);
+        return -1;
+    }
+    size_t capacity = expected >= 0 ? (size_t)expected : max_tasks;
+    set->tasks = (TaskSpec*)malloc((capacity > 0 ? capacity : 1) * sizeof(TaskSpec));
+    if (!set->tasks) {
+        printf("Out of memory loading %s\n", path);
+        unmap_file(&mf);
+        return -1;
+    }
+
+    int status = 0;
+    for (;;) {
+        if (expected >= 0 && set->count == expected) break;
+
+        int v[3];
+        int r = parse_int(&c, &v[0]);
+        if (r == 0) break;
+        if (r > 0) r = parse_int(&c, &v[1]);
+        if (r > 0) r = parse_int(&c, &v[2]);
+        if (r <= 0) {
+            printf("%s:%d: expected \"arrival wcet period\"\n", path, c.line);
+            status = -1;
+            break;
+        }
+        if (v[0] < 0 || v[1] < 0 || v[2] <= 0) {
+            printf("%s:%d: invalid task %d %d %d\n", path, c.line, v[0], v[1], v[2]);
+            status = -1;
+            break;
+        }
+
+        TaskSpec* t = &set->tasks[set->count++];
+        t->arrival = v[0];
+        t->wcet = v[1];
+        t->period = v[2];
+    }
+
+    if (status == 0 && expected >= 0 && set->count < expected) {
+        printf("%s: expected %d tasks, found %d\n", path, expected, set->count);
+        status = -1;
+    }
+    if (status == 0 && expected >= 0) {
+        int extra;
+        if (parse_int(&c, &extra) != 0) {
+            printf("%s:%d: data after the last of %d tasks ignored\n", path, c.line, expected);
+        }
+    }
+
+    unmap_file(&mf);
+    if (status != 0) {
+        free_taskset(set);
+    }
+    return status;
+}
+
+void free_taskset(TaskSet* set) {
+    free(set->tasks);
+    set->tasks = NULL;
+    set->count = 0;
+}
+
+int load_actual_times(const char* path, float* actual, int max_count) {
+    MappedFile mf;
+    if (map_file(path, &mf) != 0) return -1;
+
+    Cursor c = { mf.data, mf.data + mf.size, 1 };
+    int count = 0;
+    while (count < max_count && parse_float(&c, &actual[count]) == 1) {
+        count++;
+    }
+
+    unmap_file(&mf);
+    return count;
+}
+
+void print_usage(const char* program, unsigned accepted) {
+    printf("Usage: %s [options]\n", program);
+    printf("  -t, --tasks FILE      Task set (default tasks.txt)\n");
+    printf("  -f, --format FORMAT   auto, plain (arrival wcet period per line) or\n");
+    printf("                        counted (task count first); default auto\n");
+    printf("  -o, --output FILE     Schedule output file\n");
+    if (accepted & CLI_ACTUAL) {
+        printf("  -a, --actual FILE     Actual execution times (default actual.txt)\n");
+    }
+    if (accepted & CLI_SPORADIC) {
+        printf("      --sporadic FILE   Sporadic tasks (default sporadic.txt)\n");
+    }
+    if (accepted & CLI_APERIODIC) {
+        printf("      --aperiodic FILE  Aperiodic requests (default aperiodic.txt)\n");
+    }
+    if (accepted & CLI_SERVER) {
+        printf("      --server FILE     Aperiodic server (default server.txt)\n");
+    }
+    if (accepted & CLI_RESOURCES) {
+        printf("      --resources FILE  Critical sections (default resources.txt)\n");
+    }
+    if (accepted & CLI_PREEMPTION) {
+        printf("      --preemption FILE Preemption points (default preemption.txt)\n");
+    }
+    if (accepted & CLI_POLICY) {
+        printf("  -p, --policy NAME     Scheduling policy for the written schedule: rm,\n");
+        printf("                        rmrcs (default), pt (preemption thresholds),\n");
+        printf("                        lp (limited preemption at fixed points), edf or\n");
+        printf("                        edfrcs (EDF with RM-RCS style deferred preemption)\n");
+    }
+    if (accepted & CLI_COMPARE) {
+        printf("      --compare         Run every policy and report them side by side\n");
+    }
+    if (accepted & CLI_TRACE) {
+        printf("      --trace FILE      Also write the schedule as a Chrome/Perfetto JSON trace\n");
+    }
+    if (accepted & CLI_SEARCH) {
+        printf("      --search GOAL     Search feasible priority orderings (Audsley OPA, pruned,\n");
+        printf("                        in parallel) for the fewest context switches (cs) or\n");
+        printf("                        the smallest WCRT of task N (wcrt:N); rm or rmrcs only\n");
+    }
+    if (accepted & CLI_PRIORITIES) {
+        printf("      --priorities FILE Priority ordering for the fixed-priority policies;\n");
+        printf("                        with --search, where the ordering found is written\n");
+    }
+    if (accepted & CLI_HARMONIZE) {
+        printf("      --harmonize PCT   Propose periods shortened by at most PCT percent\n");
+        printf("                        (or PCT1,PCT2,... per task) with the smallest\n");
+        printf("                        hyperperiod that stays schedulable\n");
+    }
+    if (accepted & CLI_STATS) {
+        printf("      --stats FILE      Write profiling counters and per-phase wall time\n");
+        printf("                        as JSON (- for stdout)\n");
+    }
+    printf("  -h, --help            Show this help\n");
+}
+
+int parse_cli_options(int argc, char** argv, unsigned accepted, CliOptions* opts) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char** target = NULL;
+        unsigned option = 0;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            print_usage(argv[0], accepted);
+            return 1;
+        }
+        if (strcmp(arg, "--compare") == 0 && (accepted & CLI_COMPARE)) {
+            opts->compare = 1;
+            continue;
+        }
+
+        if (strcmp(arg, "-t") == 0 || strcmp(arg, "--tasks") == 0) target = &opts->tasks_path;
+        else if (strcmp(arg, "-o") == 0 || strcmp(arg, "--output") == 0) target = &opts->output_path;
+        else if (strcmp(arg, "-a") == 0 || strcmp(arg, "--actual") == 0) {
+            target = &opts->actual_path;
+            option = CLI_ACTUAL;
+        } else if (strcmp(arg, "--sporadic") == 0) {
+            target = &opts->sporadic_path;
+            option = CLI_SPORADIC;
+        } else if (strcmp(arg, "--aperiodic") == 0) {
+            target = &opts->aperiodic_path;
+            option = CLI_APERIODIC;
+        } else if (strcmp(arg, "--server") == 0) {
+            target = &opts->server_path;
+            option = CLI_SERVER;
+        } else if (strcmp(arg, "--resources") == 0) {
+            target = &opts->resources_path;
+            option = CLI_RESOURCES;
+        } else if (strcmp(arg, "--preemption") == 0) {
+            target = &opts->preemption_path;
+            option = CLI_PREEMPTION;
+        } else if (strcmp(arg, "--trace") == 0) {
+            target = &opts->trace_path;
+            option = CLI_TRACE;
+        } else if (strcmp(arg, "--search") == 0) {
+            target = &opts->search;
+            option = CLI_SEARCH;
+        } else if (strcmp(arg, "--priorities") == 0) {
+            target = &opts->priorities_path;
+            option = CLI_PRIORITIES;
+        } else if (strcmp(arg, "--harmonize") == 0) {
+            target = &opts->harmonize;
+            option = CLI_HARMONIZE;
+        } else if (strcmp(arg, "--stats") == 0) {
+            target = &opts->stats_path;
+            option = CLI_STATS;
+        } else if (strcmp(arg, "-p") == 0 || strcmp(arg, "--policy") == 0) {
+            target = &opts->policy;
+            option = CLI_POLICY;
+        } else if (strcmp(arg, "-f") != 0 && strcmp(arg, "--format") != 0) {
+            option = ~0u; // Unknown to every program
+        }
+
+        // Options another simulator implements are rejected, not ignored
+        if (option && !(accepted & option)) {
+            printf("Unknown option %s\n", arg);
+            print_usage(argv[0], accepted);
+            return -1;
+        }
+
+        if (i + 1 >= argc) {
+            printf("Option %s needs a value\n", arg);
+            return -1;
+        }
+        const char* value = argv[++i];
+
+        if (target) {
+            *target = value;
+        } else if (strcmp(value, "auto") == 0) {
+            opts->format = TASKSET_FORMAT_AUTO;
+        } else if (strcmp(value, "plain") == 0) {
+            opts->format = TASKSET_FORMAT_PLAIN;
+        } else if (strcmp(value, "counted") == 0) {
+            opts->format = TASKSET_FORMAT_COUNTED;
+        } else {
+            printf("Unknown task set format %s\n", value);
+            return -1;
+        }
+    }
+    return 0;
+}
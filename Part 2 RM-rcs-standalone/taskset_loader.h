@@ -0,0 +1,70 @@
+#ifndef TASKSET_LOADER_H
+#define TASKSET_LOADER_H
+
+// Task set file formats
+#define TASKSET_FORMAT_AUTO    0
+#define TASKSET_FORMAT_PLAIN   1 // "arrival wcet period" per line (tasks.txt)
+#define TASKSET_FORMAT_COUNTED 2 // Task count N first, then N triplets (main_g_backup.c)
+
+typedef struct {
+    int arrival;
+    int wcet;
+    int period;
+} TaskSpec;
+
+typedef struct {
+    TaskSpec* tasks;
+    int count;
+    int format; // Format actually parsed (never TASKSET_FORMAT_AUTO)
+} TaskSet;
+
+// Command-line front end shared by the simulators
+typedef struct {
+    const char* tasks_path;
+    const char* actual_path;
+    const char* output_path;
+    const char* sporadic_path;
+    const char* aperiodic_path;
+    const char* server_path;
+    const char* resources_path;
+    int format;
+    const char* policy;
+    int compare; // Run every policy and report them side by side
+    const char* preemption_path;
+    const char* trace_path; // Chrome/Perfetto trace of the schedule, NULL for none
+    const char* search;     // Priority ordering search goal ("cs" or "wcrt:N"), NULL for none
+    const char* priorities_path; // Priority ordering to use, or where --search writes it
+    const char* harmonize;  // Period tolerance bands in percent, NULL for no advice
+    const char* stats_path; // Profiling counters as JSON ("-" for stdout), NULL for none
+} CliOptions;
+
+// Options a program accepts besides -t, -f, -o and -h; any other option is
+// rejected as unknown
+#define CLI_ACTUAL     (1u << 0)
+#define CLI_SPORADIC   (1u << 1)
+#define CLI_APERIODIC  (1u << 2)
+#define CLI_SERVER     (1u << 3)
+#define CLI_RESOURCES  (1u << 4)
+#define CLI_PREEMPTION (1u << 5)
+#define CLI_POLICY     (1u << 6)
+#define CLI_COMPARE    (1u << 7)
+#define CLI_TRACE      (1u << 8)
+#define CLI_SEARCH     (1u << 9)
+#define CLI_PRIORITIES (1u << 10)
+#define CLI_HARMONIZE  (1u << 11)
+#define CLI_STATS      (1u << 12)
+
+// Fill in defaults first (designated initializers; unset fields are NULL or 0);
+// returns 0 to run, 1 after --help, -1 on bad usage
+int parse_cli_options(int argc, char** argv, unsigned accepted, CliOptions* opts);
+void print_usage(const char* program, unsigned accepted);
+
+// Parses the memory-mapped file in place; returns 0 on success, -1 on error
+int load_taskset(const char* path, int format, TaskSet* set);
+void free_taskset(TaskSet* set);
+const char* taskset_format_name(int format);
+
+// One execution time per line; returns the number read or -1 if unreadable
+int load_actual_times(const char* path, float* actual, int max_count);
+
+#endif // TASKSET_LOADER_H
@@ -0,0 +1,121 @@
+#include "trace_export.h"
+#include <string.h>
+
+static void flush_buffer(TraceWriter* tw) {
+    if (tw->len > 0) {
+        fwrite(tw->buf, 1, tw->len, tw->fp);
+        tw->len = 0;
+    }
+}
+
+// Longest single event is well under this, so one check per event is enough
+#define TRACE_EVENT_MAX 1024
+
+static void reserve(TraceWriter* tw) {
+    if (tw->len + TRACE_EVENT_MAX > TRACE_BUFFER_SIZE) flush_buffer(tw);
+}
+
+static void put_str(TraceWriter* tw, const char* s) {
+    size_t n = strlen(s);
+    memcpy(tw->buf + tw->len, s, n);
+    tw->len += n;
+}
+
+// JSON string body; names are short, so they are cut rather than split across flushes
+static void put_escaped(TraceWriter* tw, const char* s) {
+    for (int i = 0; s[i] && i < 128; i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') {
+            tw->buf[tw->len++] = '\\';
+            tw->buf[tw->len++] = c;
+        } else if ((unsigned char)c >= 0x20) {
+            tw->buf[tw->len++] = c;
+        }
+    }
+}
+
+// Hand-rolled, as printf dominates the cost of a 10^7-event trace
+static void put_int(TraceWriter* tw, long long v) {
+    char digits[24];
+    int n = 0;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    if (v < 0) tw->buf[tw->len++] = '-';
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u > 0);
+    while (n > 0) tw->buf[tw->len++] = digits[--n];
+}
+
+static void begin_event(TraceWriter* tw, const char* ph, int tid, const char* name) {
+    reserve(tw);
+    put_str(tw, tw->events > 0 ? ",\n{\"ph\":\"" : "\n{\"ph\":\"");
+    put_str(tw, ph);
+    put_str(tw, "\",\"pid\":1,\"tid\":");
+    put_int(tw, tid);
+    put_str(tw, ",\"name\":\"");
+    put_escaped(tw, name);
+    put_str(tw, "\"");
+    tw->events++;
+}
+
+int trace_open(TraceWriter* tw, const char* path, const char* process_name) {
+    tw->fp = fopen(path, "wb");
+    tw->len = 0;
+    tw->events = 0;
+    if (!tw->fp) {
+        printf("Error opening trace file %s\n", path);
+        return -1;
+    }
+    put_str(tw, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    begin_event(tw, "M", 0, "process_name");
+    put_str(tw, ",\"args\":{\"name\":\"");
+    put_escaped(tw, process_name);
+    put_str(tw, "\"}}");
+    return 0;
+}
+
+long long trace_close(TraceWriter* tw) {
+    reserve(tw);
+    put_str(tw, "\n]}\n");
+    flush_buffer(tw);
+    int failed = ferror(tw->fp);
+    if (fclose(tw->fp) != 0) failed = 1;
+    tw->fp = NULL;
+    return failed ? -1 : tw->events;
+}
+
+void trace_track(TraceWriter* tw, int tid, const char* name, int sort_index) {
+    begin_event(tw, "M", tid, "thread_name");
+    put_str(tw, ",\"args\":{\"name\":\"");
+    put_escaped(tw, name);
+    put_str(tw, "\"}}");
+    begin_event(tw, "M", tid, "thread_sort_index");
+    put_str(tw, ",\"args\":{\"sort_index\":");
+    put_int(tw, sort_index);
+    put_str(tw, "}}");
+}
+
+void trace_slice(TraceWriter* tw, int tid, const char* name, long long ts, long long dur) {
+    begin_event(tw, "X", tid, name);
+    put_str(tw, ",\"ts\":");
+    put_int(tw, ts);
+    put_str(tw, ",\"dur\":");
+    put_int(tw, dur);
+    put_str(tw, "}");
+}
+
+void trace_instant(TraceWriter* tw, int tid, const char* name, long long ts,
+                   const char* arg_name, long long arg_value) {
+    begin_event(tw, "i", tid, name);
+    put_str(tw, ",\"s\":\"t\",\"ts\":");
+    put_int(tw, ts);
+    if (arg_name) {
+        put_str(tw, ",\"args\":{\"");
+        put_escaped(tw, arg_name);
+        put_str(tw, "\":");
+        put_int(tw, arg_value);
+        put_str(tw, "}");
+    }
+    put_str(tw, "}");
+}
@@ -0,0 +1,33 @@
+#ifndef TRACE_EXPORT_H
+#define TRACE_EXPORT_H
+
+#include <stdio.h>
+
+// Streaming writer for the Chrome Trace Event format, opened by Perfetto
+// (ui.perfetto.dev) and chrome://tracing. Events go through a fixed buffer
+// straight to the file, so memory use does not depend on the trace length.
+// Timestamps and durations are in microseconds.
+
+#define TRACE_BUFFER_SIZE 65536
+
+typedef struct {
+    FILE* fp;
+    char buf[TRACE_BUFFER_SIZE];
+    size_t len;
+    long long events;
+} TraceWriter;
+
+// Returns 0 on success, -1 if the file cannot be created
+int trace_open(TraceWriter* tw, const char* path, const char* process_name);
+// Ends the JSON document; returns the number of events written, -1 on a write error
+long long trace_close(TraceWriter* tw);
+
+// Names track tid; tracks are sorted by sort_index in the viewer
+void trace_track(TraceWriter* tw, int tid, const char* name, int sort_index);
+// A slice of duration dur starting at ts ("X" event)
+void trace_slice(TraceWriter* tw, int tid, const char* name, long long ts, long long dur);
+// A marker at ts on one track ("i" event); arg_name may be NULL
+void trace_instant(TraceWriter* tw, int tid, const char* name, long long ts,
+                   const char* arg_name, long long arg_value);
+
+#endif // TRACE_EXPORT_H